@@ -0,0 +1,257 @@
+#include "asset_pack.hpp"
+#include "../utility/logger/logger.hpp"
+#include <cstring>
+#include <lz4.h>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const unsigned char *packData = nullptr;
+std::size_t packSize = 0;
+std::unordered_map<std::string, const PackEntry *> entries;
+
+#ifdef _WIN32
+HANDLE fileHandle = INVALID_HANDLE_VALUE;
+HANDLE mappingHandle = nullptr;
+#endif
+
+const unsigned char *mapFile(const char *path, std::size_t &size) {
+#ifdef _WIN32
+  fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (fileHandle == INVALID_HANDLE_VALUE) {
+    return nullptr;
+  }
+
+  LARGE_INTEGER fileSize;
+  GetFileSizeEx(fileHandle, &fileSize);
+  size = static_cast<std::size_t>(fileSize.QuadPart);
+
+  mappingHandle =
+      CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mappingHandle) {
+    CloseHandle(fileHandle);
+    fileHandle = INVALID_HANDLE_VALUE;
+    return nullptr;
+  }
+
+  return static_cast<const unsigned char *>(
+      MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+#else
+  const int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size == 0) {
+    close(fd);
+    return nullptr;
+  }
+  size = static_cast<std::size_t>(info.st_size);
+
+  void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd); // The mapping stays valid after the descriptor is closed
+
+  return data == MAP_FAILED ? nullptr : static_cast<const unsigned char *>(data);
+#endif
+}
+
+void unmapFile() {
+#ifdef _WIN32
+  UnmapViewOfFile(packData);
+  CloseHandle(mappingHandle);
+  CloseHandle(fileHandle);
+  mappingHandle = nullptr;
+  fileHandle = INVALID_HANDLE_VALUE;
+#else
+  munmap(const_cast<unsigned char *>(packData), packSize);
+#endif
+}
+
+// Largest texture side and decompressed size an entry may claim; both keep
+// the sizes handed to SDL and LZ4 well inside an int
+constexpr std::uint32_t maxTextureSide = 16384;
+constexpr std::uint64_t maxRawSize = 256ull * 1024 * 1024;
+
+bool inBounds(const PackEntry &entry) {
+  return entry.offset <= packSize && entry.size <= packSize - entry.offset;
+}
+
+/**
+ * Whether the sizes of an entry agree with each other, so loading it never
+ * writes or reads past a buffer: a texture holds exactly width * height * 4
+ * bytes once decompressed, and nothing decompresses to more than maxRawSize
+ */
+bool consistent(const PackEntry &entry) {
+  if (entry.compression != PackCompression::None &&
+      entry.compression != PackCompression::LZ4) {
+    return false;
+  }
+  const std::uint64_t bytes = entry.compression == PackCompression::None
+                                  ? entry.size
+                                  : entry.rawSize;
+  if (bytes > maxRawSize) {
+    return false;
+  }
+
+  if (entry.type == PackEntryType::Texture) {
+    return entry.width > 0 && entry.height > 0 &&
+           entry.width <= maxTextureSide && entry.height <= maxTextureSide &&
+           bytes == std::uint64_t{entry.width} * entry.height * 4;
+  }
+  return entry.type == PackEntryType::Raw;
+}
+
+} // namespace
+
+/**
+ * Map the pack and index its table of contents
+ * @param path The path to the pack file
+ * @return Whether the pack could be opened
+ */
+bool AssetPack::Open(const char *path) {
+  Close();
+
+  packData = mapFile(path, packSize);
+  if (!packData) {
+    return false;
+  }
+
+  PackHeader header;
+  if (packSize < sizeof(header)) {
+    LOG_ERROR("Asset pack too small: %s", path);
+    Close();
+    return false;
+  }
+  std::memcpy(&header, packData, sizeof(header));
+
+  // The table must fit after its offset; compared without a sum that could
+  // wrap around for large header values
+  if (std::memcmp(header.magic, packMagic, sizeof(packMagic)) != 0 ||
+      header.version != packVersion || header.tocOffset > packSize ||
+      header.entryCount > (packSize - header.tocOffset) / sizeof(PackEntry)) {
+    LOG_ERROR("Invalid asset pack: %s", path);
+    Close();
+    return false;
+  }
+
+  const auto *toc =
+      reinterpret_cast<const PackEntry *>(packData + header.tocOffset);
+  for (std::uint32_t i = 0; i < header.entryCount; i++) {
+    if (!inBounds(toc[i]) || !consistent(toc[i])) {
+      LOG_ERROR("Corrupt asset pack entry: %.*s",
+                static_cast<int>(packNameLength), toc[i].name);
+      continue;
+    }
+    // The cooker terminates every name; a corrupt pack may not
+    entries.emplace(
+        std::string(toc[i].name, strnlen(toc[i].name, packNameLength)),
+        &toc[i]);
+  }
+
+  return true;
+}
+
+void AssetPack::Close() {
+  if (packData) {
+    unmapFile();
+  }
+  packData = nullptr;
+  packSize = 0;
+  entries.clear();
+}
+
+bool AssetPack::IsOpen() { return packData != nullptr; }
+
+const PackEntry *AssetPack::Find(const std::string &name) {
+  auto it = entries.find(name);
+  return it != entries.end() ? it->second : nullptr;
+}
+
+/**
+ * Create a surface from a texture entry.
+ * Uncompressed pixels are used in place, straight from the mapping.
+ */
+SDL_Surface *AssetPack::LoadSurface(const std::string &name) {
+  const PackEntry *entry = Find(name);
+  if (!entry || entry->type != PackEntryType::Texture) {
+    return nullptr;
+  }
+
+  const int width = static_cast<int>(entry->width);
+  const int height = static_cast<int>(entry->height);
+  const int pitch = width * 4;
+  const unsigned char *blob = packData + entry->offset;
+
+  if (entry->compression == PackCompression::None) {
+    return SDL_CreateRGBSurfaceWithFormatFrom(
+        const_cast<unsigned char *>(blob), width, height, 32, pitch,
+        SDL_PIXELFORMAT_RGBA32);
+  }
+
+  SDL_Surface *surface =
+      SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+  if (!surface) {
+    return nullptr;
+  }
+
+  // 32bpp surfaces are tightly packed, but do not rely on it
+  std::vector<char> scratch;
+  char *pixels = static_cast<char *>(surface->pixels);
+  if (surface->pitch != pitch) {
+    scratch.resize(entry->rawSize);
+    pixels = scratch.data();
+  }
+
+  const int written = LZ4_decompress_safe(
+      reinterpret_cast<const char *>(blob), pixels,
+      static_cast<int>(entry->size), static_cast<int>(entry->rawSize));
+  if (written != static_cast<int>(entry->rawSize)) {
+    LOG_ERROR("Failed to decompress %s", name.c_str());
+    SDL_FreeSurface(surface);
+    return nullptr;
+  }
+
+  if (!scratch.empty()) {
+    for (int y = 0; y < height; y++) {
+      std::memcpy(static_cast<char *>(surface->pixels) + y * surface->pitch,
+                  scratch.data() + y * pitch, pitch);
+    }
+  }
+
+  return surface;
+}
+
+bool AssetPack::LoadText(const std::string &name, std::string &out) {
+  const PackEntry *entry = Find(name);
+  if (!entry || entry->type != PackEntryType::Raw) {
+    return false;
+  }
+
+  const char *blob = reinterpret_cast<const char *>(packData + entry->offset);
+
+  if (entry->compression == PackCompression::None) {
+    out.assign(blob, entry->size);
+    return true;
+  }
+
+  if (entry->rawSize > maxRawSize) {
+    return false; // Rejected by Open() already; never resized to it
+  }
+  out.resize(entry->rawSize);
+  const int written =
+      LZ4_decompress_safe(blob, &out[0], static_cast<int>(entry->size),
+                          static_cast<int>(entry->rawSize));
+  return written == static_cast<int>(entry->rawSize);
+}
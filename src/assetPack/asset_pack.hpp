@@ -0,0 +1,33 @@
+#ifndef ASSET_PACK_HPP
+#define ASSET_PACK_HPP
+
+#include "asset_pack_format.hpp"
+#include <SDL2/SDL.h>
+#include <string>
+
+/**
+ * AssetPack class
+ *
+ * Read-only view of the cooked asset pack. The file is memory mapped once and
+ * entries are looked up by their runtime path, so loading an asset is a
+ * table lookup plus (at most) an LZ4 decompression instead of a PNG decode.
+ *
+ * Lookups are thread safe once Open() has returned.
+ *
+ * @author: @iMeyu
+ */
+class AssetPack {
+public:
+  static bool Open(const char *path);
+  static void Close();
+  static bool IsOpen();
+
+  static const PackEntry *Find(const std::string &name);
+
+  // Create a RGBA32 surface for a texture entry, nullptr if missing
+  static SDL_Surface *LoadSurface(const std::string &name);
+  // Copy a raw entry into out, false if missing
+  static bool LoadText(const std::string &name, std::string &out);
+};
+
+#endif
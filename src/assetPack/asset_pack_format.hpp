@@ -0,0 +1,49 @@
+// asset_pack_format.hpp
+// On-disk layout of the cooked asset pack, shared by the AssetCooker tool and
+// the runtime reader.
+//
+// [PackHeader][blob][blob]...[PackEntry x entryCount]
+//
+// Blobs are aligned to packAlignment. Textures are stored as pre-decoded
+// RGBA32 pixels (optionally LZ4 compressed), everything else as raw bytes.
+#ifndef ASSET_PACK_FORMAT_HPP
+#define ASSET_PACK_FORMAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+constexpr char packMagic[4] = {'G', 'P', 'A', 'K'};
+constexpr std::uint32_t packVersion = 1;
+constexpr std::uint64_t packAlignment = 16;
+constexpr std::size_t packNameLength = 96;
+
+enum class PackEntryType : std::uint32_t {
+  Raw = 0,     // Bytes copied as they are (e.g. .map files)
+  Texture = 1, // Tightly packed RGBA32 pixels, width * height * 4 bytes
+};
+
+enum class PackCompression : std::uint32_t {
+  None = 0,
+  LZ4 = 1,
+};
+
+struct PackHeader {
+  char magic[4];
+  std::uint32_t version;
+  std::uint32_t entryCount;
+  std::uint32_t reserved;
+  std::uint64_t tocOffset; // Offset of the first PackEntry
+};
+
+struct PackEntry {
+  char name[packNameLength]; // Runtime path, e.g. "assets/maps/lvl1.map"
+  PackEntryType type;
+  PackCompression compression;
+  std::uint64_t offset;  // Offset of the blob from the start of the pack
+  std::uint64_t size;    // Stored size of the blob
+  std::uint64_t rawSize; // Size once decompressed
+  std::uint32_t width;   // Texture only
+  std::uint32_t height;  // Texture only
+};
+
+#endif
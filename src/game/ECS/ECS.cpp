@@ -1,6 +1,485 @@
 #include "ECS.hpp"
+#include "../components/components.hpp"
+#include "../snapshot/snapshot.hpp"
+#include "../../utility/logger/logger.hpp"
+
+namespace {
+
+/**
+ * Calls f with a null T* for every component type T, in registry order.
+ * The pointer only carries the type.
+ */
+template <typename F, typename... Ts>
+void forEachComponentType(TypeList<Ts...>, F &&f) {
+  (f(static_cast<Ts *>(nullptr)), ...);
+}
+
+// Snapshots store the component and group bitsets as 64-bit words
+static_assert(maxComponents <= 64 && maxGroups <= 64,
+              "Snapshot bitsets are 64 bits wide");
+
+// Per-entity header written by Manager::save
+struct SavedEntity {
+  std::uint8_t active;
+  std::uint8_t activity;
+  std::uint8_t phase;
+  std::uint64_t components;
+  std::uint64_t groups;
+};
+
+} // namespace
 
 void Entity::addGroup(Group mGroup) {
   groupBitset[mGroup] = true;
   manager.addToGroup(this, mGroup);
 }
+
+void Entity::delGroup(Group mGroup) {
+  groupBitset[mGroup] = false;
+  manager.markForRefresh(); // The group vector is pruned there
+}
+
+void Entity::destroy() {
+  if (active) {
+    active = false;
+    forEachComponentType(ComponentTypes{}, [this](auto *type) {
+      using T = std::remove_pointer_t<decltype(type)>;
+      if (hasComponent<T>()) {
+        manager.markRemoved(getComponent<T>());
+      }
+    });
+    manager.markForRefresh();
+    EventBus::Emit(EntityDestroyedEvent{this});
+  }
+}
+
+void Entity::setActivity(Activity mActivity) {
+  const bool wasAwake = isAwake();
+  activity = mActivity;
+  if (isAwake() != wasAwake) {
+    manager.markAwakeChanged();
+  }
+}
+
+void Entity::wake() {
+  if (activity == Activity::Sleeping) {
+    setActivity(Activity::Active);
+  }
+}
+
+void Entity::update() {
+  forEachComponentType(ComponentTypes{}, [this](auto *type) {
+    using T = std::remove_pointer_t<decltype(type)>;
+    if (hasComponent<T>()) {
+      getComponent<T>().update();
+    }
+  });
+}
+
+void Entity::draw() {
+  forEachComponentType(ComponentTypes{}, [this](auto *type) {
+    using T = std::remove_pointer_t<decltype(type)>;
+    if (hasComponent<T>()) {
+      getComponent<T>().draw();
+    }
+  });
+}
+
+void Manager::update() {
+  if (awakeChanged) {
+    rebuildAwake();
+  }
+
+  std::apply(
+      [](auto &...store) {
+        auto updateAll = [](auto &components) {
+          for (auto *c : components) {
+            if (c->entity->updatesThisTick()) {
+              c->update();
+            }
+          }
+        };
+        (updateAll(store), ...);
+      },
+      awake);
+}
+
+/**
+ * Copy the components of awake entities, keeping the store order
+ */
+void Manager::rebuildAwake() {
+  forEachComponentType(ComponentTypes{}, [this](auto *type) {
+    using T = std::remove_pointer_t<decltype(type)>;
+    auto &live = std::get<std::vector<T *>>(awake);
+    live.clear();
+    live.reserve(getComponents<T>().size()); // Only grows with the store
+    for (T *c : getComponents<T>()) {
+      if (c->entity->isAwake()) {
+        live.push_back(c);
+      }
+    }
+  });
+  awakeChanged = false;
+}
+
+/**
+ * Keep the changes made since the end of the previous tick and during this
+ * one: a system that runs every tick finds all of its changes in the logs
+ */
+void Manager::endTick() {
+  const std::uint64_t floor = lastEndClock;
+  std::apply(
+      [floor](auto &...log) {
+        auto dropOld = [floor](auto &entries) {
+          entries.erase(std::remove_if(std::begin(entries), std::end(entries),
+                                       [floor](const auto &entry) {
+                                         return entry.stamp <= floor;
+                                       }),
+                        std::end(entries));
+        };
+        ((dropOld(log.changed), dropOld(log.added), dropOld(log.removed)),
+         ...);
+      },
+      changeLogs);
+  logFloor = floor;
+  lastEndClock = changeMark();
+
+  // Room for every component to change in both ticks the logs hold, so the
+  // logs grow when entities are spawned rather than when more of them move
+  forEachComponentType(ComponentTypes{}, [this](auto *type) {
+    using T = std::remove_pointer_t<decltype(type)>;
+    auto &changed = changeLog<T>().changed;
+    const std::size_t room = 2 * getComponents<T>().size();
+    if (changed.capacity() < room) {
+      changed.reserve(room);
+    }
+  });
+}
+
+/**
+ * Advance the tick clock and emit the TimerEvents due at the new tick, in
+ * the order their timers were scheduled
+ */
+void Manager::beginTick() {
+  tick++;
+  timers.Advance(tick, [](TimerId id, const EntityTimer &timer) {
+    EventBus::Emit(TimerEvent{timer.entity, timer.tag, id});
+  });
+}
+
+void Manager::setReducedInterval(std::uint32_t interval) {
+  // Phases are 8 bits
+  reducedInterval = std::clamp<std::uint32_t>(interval, 1, 256);
+}
+
+void Manager::refresh() {
+  if (!needsRefresh) {
+    return;
+  }
+  needsRefresh = false;
+  awakeChanged = true; // Its copies may point to destroyed components
+
+  // erase() never releases capacity, so pruning does not allocate
+
+  // Drop the components of inactive entities from their stores
+  std::apply(
+      [](auto &...store) {
+        auto dropInactive = [](auto &components) {
+          components.erase(std::remove_if(std::begin(components),
+                                          std::end(components),
+                                          [](const Component *c) {
+                                            return !c->entity->isActive();
+                                          }),
+                           std::end(components));
+        };
+        (dropInactive(store), ...);
+      },
+      stores);
+
+  // And from the change logs, which would otherwise hand them out after
+  // they are deleted; removals keep them, as keys
+  std::apply(
+      [](auto &...log) {
+        auto dropInactive = [](auto &entries) {
+          entries.erase(std::remove_if(std::begin(entries), std::end(entries),
+                                       [](const auto &entry) {
+                                         return !entry.component->entity
+                                                     ->isActive();
+                                       }),
+                        std::end(entries));
+        };
+        ((dropInactive(log.changed), dropInactive(log.added)), ...);
+      },
+      changeLogs);
+
+  // Timers of destroyed entities; a pass over the pending timers, only on
+  // ticks that destroy something
+  if (timers.Size() > 0) {
+    timers.CancelIf([](const EntityTimer &timer) {
+      return timer.entity && !timer.entity->isActive();
+    });
+  }
+
+  /**
+   * Remove inactive entities from each group.
+   */
+  for (auto i(0u); i < maxGroups; i++) {
+    auto &v(groupedEntities[i]);
+    v.erase(std::remove_if(std::begin(v), std::end(v),
+                           [i](Entity *mEntity) {
+                             return !mEntity->isActive() ||
+                                    !mEntity->hasGroup(i);
+                           }),
+            std::end(v));
+  }
+
+  entities.erase(std::remove_if(std::begin(entities), std::end(entities),
+                                [](const std::unique_ptr<Entity> &mEntity) {
+                                  return !mEntity->isActive();
+                                }),
+                 std::end(entities));
+}
+
+void Entity::save(SnapshotWriter &out) const {
+  forEachComponentType(ComponentTypes{}, [this, &out](auto *type) {
+    using T = std::remove_pointer_t<decltype(type)>;
+    if (hasComponent<T>()) {
+      getComponent<T>().save(out);
+    }
+  });
+}
+
+void Entity::load(SnapshotReader &in) {
+  forEachComponentType(ComponentTypes{}, [this, &in](auto *type) {
+    using T = std::remove_pointer_t<decltype(type)>;
+    if (hasComponent<T>()) {
+      getComponent<T>().load(in);
+    }
+  });
+}
+
+void Manager::save(SnapshotWriter &out) {
+  out.write(tick);
+  out.write(static_cast<std::uint32_t>(entities.size()));
+
+  // Pointers are written as these indices
+  for (std::size_t i = 0; i < entities.size(); i++) {
+    entities[i]->index = static_cast<std::uint32_t>(i);
+  }
+
+  for (const auto &e : entities) {
+    SavedEntity saved{};
+    saved.active = e->active ? 1 : 0;
+    saved.activity = static_cast<std::uint8_t>(e->activity);
+    saved.phase = e->phase;
+    saved.components = e->componentBitset.to_ullong();
+    saved.groups = e->groupBitset.to_ullong();
+    out.write(saved);
+  }
+
+  for (const auto &e : entities) {
+    e->save(out);
+  }
+
+  for (const auto &group : groupedEntities) {
+    out.write(static_cast<std::uint32_t>(group.size()));
+    for (const Entity *e : group) {
+      out.writeEntity(e);
+    }
+  }
+
+  // Store order is update order
+  std::apply(
+      [&out](auto &...store) {
+        auto saveOrder = [&out](auto &components) {
+          out.write(static_cast<std::uint32_t>(components.size()));
+          for (const Component *c : components) {
+            out.writeEntity(c->entity);
+          }
+        };
+        (saveOrder(store), ...);
+      },
+      stores);
+
+  // Pending timers keep their ids, so the ones the game holds stay valid
+  out.write(static_cast<std::uint32_t>(timers.Size()));
+  timers.ForEach([&out](const TimerWheel<EntityTimer>::Timer &timer) {
+    out.write(timer.id);
+    out.write(timer.due);
+    out.write(timer.sequence);
+    out.write(timer.period);
+    out.writeEntity(timer.value.entity);
+    out.write(timer.value.tag);
+  });
+}
+
+bool Manager::load(SnapshotReader &in) {
+  std::uint32_t count = 0;
+  // The entity table must fit in what is left before it is allocated
+  if (!in.read(tick) || !in.read(count) ||
+      count > in.remaining() / sizeof(SavedEntity)) {
+    return false;
+  }
+
+  std::vector<SavedEntity> saved(count);
+  for (SavedEntity &entity : saved) {
+    if (!in.read(entity)) {
+      return false;
+    }
+  }
+
+  // Keep the entities whose component types match, create the others
+  std::vector<std::unique_ptr<Entity>> restored;
+  std::vector<Entity *> order;
+  std::vector<Entity *> created;
+  restored.reserve(count);
+  order.reserve(count);
+
+  for (std::uint32_t i = 0; i < count; i++) {
+    const ComponentBitset components(saved[i].components);
+
+    if (i < entities.size() && entities[i]->componentBitset == components) {
+      restored.push_back(std::move(entities[i]));
+    } else {
+      Entity *e = new Entity(*this);
+      restored.emplace_back(e);
+      created.push_back(e);
+
+      forEachComponentType(ComponentTypes{}, [e, &components](auto *type) {
+        using T = std::remove_pointer_t<decltype(type)>;
+        if (components[getComponentTypeID<T>()]) {
+          e->emplaceComponent<T>();
+        }
+      });
+    }
+
+    Entity *e = restored.back().get();
+    e->index = i;
+    e->active = saved[i].active != 0;
+    if (!e->active) {
+      needsRefresh = true;
+    }
+    e->activity =
+        saved[i].activity <= static_cast<std::uint8_t>(Activity::Static)
+            ? static_cast<Activity>(saved[i].activity)
+            : Activity::Active;
+    e->phase = saved[i].phase;
+    e->groupBitset = GroupBitset(saved[i].groups);
+    order.push_back(e);
+  }
+
+  // New components initialise as addComponent would, once all exist; load
+  // then overwrites what init set
+  for (Entity *e : created) {
+    forEachComponentType(ComponentTypes{}, [e](auto *type) {
+      using T = std::remove_pointer_t<decltype(type)>;
+      if (e->hasComponent<T>()) {
+        e->getComponent<T>().init();
+      }
+    });
+  }
+
+  in.setEntities(&order);
+  for (Entity *e : order) {
+    e->load(in);
+  }
+
+  for (auto &group : groupedEntities) {
+    group.clear();
+    std::uint32_t size = 0;
+    in.read(size);
+    for (std::uint32_t k = 0; k < size && in.ok(); k++) {
+      if (Entity *e = in.readEntity()) {
+        group.push_back(e);
+      }
+    }
+  }
+
+  std::apply(
+      [&in](auto &...store) {
+        auto loadOrder = [&in](auto &components) {
+          using T = std::remove_pointer_t<
+              typename std::decay_t<decltype(components)>::value_type>;
+          components.clear();
+          std::uint32_t size = 0;
+          in.read(size);
+          for (std::uint32_t k = 0; k < size && in.ok(); k++) {
+            Entity *e = in.readEntity();
+            if (e && e->hasComponent<T>()) {
+              components.push_back(&e->getComponent<T>());
+            }
+          }
+        };
+        (loadOrder(store), ...);
+      },
+      stores);
+
+  timers.Reset(tick);
+  std::uint32_t pending = 0;
+  in.read(pending);
+  for (std::uint32_t k = 0; k < pending && in.ok(); k++) {
+    TimerWheel<EntityTimer>::Timer timer{};
+    in.read(timer.id);
+    in.read(timer.due);
+    in.read(timer.sequence);
+    in.read(timer.period);
+    timer.value.entity = in.readEntity();
+    in.read(timer.value.tag);
+    if (in.ok()) {
+      timers.Restore(timer);
+    }
+  }
+
+  // Entities left out are destroyed here, after nothing points to them
+  entities = std::move(restored);
+  awakeChanged = true;
+
+  // The logs may point to deleted components; whoever derives state from
+  // components rebuilds it
+  std::apply(
+      [](auto &...log) {
+        ((log.changed.clear(), log.added.clear(), log.removed.clear()), ...);
+      },
+      changeLogs);
+  rebuiltStamp = changeMark() + 1;
+  logFloor = rebuiltStamp;
+  in.setEntities(nullptr);
+
+  return in.ok() && in.atEnd();
+}
+
+/**
+ * Memory is counted from sizes and capacities: the components themselves,
+ * their store slots and their owning pointers in the entities
+ */
+void Manager::reportMemory() const {
+  std::size_t entityBytes = entities.capacity() * sizeof(entities[0]);
+  std::array<std::size_t, 4> activities{};
+  for (const auto &e : entities) {
+    entityBytes += sizeof(Entity) + e->components.capacity() *
+                                        sizeof(std::unique_ptr<Component>);
+    activities[static_cast<std::size_t>(e->activity)]++;
+  }
+  for (const auto &group : groupedEntities) {
+    entityBytes += group.capacity() * sizeof(Entity *);
+  }
+  LOG_INFO("ECS: %zu entities, %zu bytes", entities.size(), entityBytes);
+  LOG_INFO("  %zu active, %zu reduced rate, %zu sleeping, %zu static",
+           activities[0], activities[1], activities[2], activities[3]);
+
+  std::size_t index = 0;
+  std::apply(
+      [&index](const auto &...store) {
+        auto report = [&index](const auto &components) {
+          using T = std::remove_pointer_t<
+              typename std::decay_t<decltype(components)>::value_type>;
+          LOG_INFO("  %-16s %6zu components %9zu bytes",
+                   componentNames[index], components.size(),
+                   components.size() * sizeof(T) +
+                       components.capacity() * sizeof(T *));
+          index++;
+        };
+        (report(store), ...);
+      },
+      stores);
+}
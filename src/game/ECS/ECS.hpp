@@ -8,49 +8,55 @@
 #define ECS_HPP
 
 #include "../../utility/utility.hpp"
+#include "../eventBus/event_bus.hpp"
+#include "../timerWheel/timer_wheel.hpp"
+#include "registry.hpp"
 #include <algorithm> // Standard C++ algorithms (e.g., std::find)
 #include <array>     // Fixed-size arrays
 #include <bitset>    // Bitset management (useful for flags)
+#include <cstdint>   // Fixed-width integers
 #include <memory>    // Smart pointers (e.g., std::unique_ptr)
+#include <tuple>     // Per-type component stores
 #include <vector>    // Dynamic arrays (vectors)
 
 // Forward declaration: we tell the compiler these classes exist
 class Component;
 class Entity;
 class Manager;
+class SnapshotWriter;
+class SnapshotReader;
+class Prefab;
 
 using Group = std::size_t;
 
+/**
+ * How often an entity's components are updated
+ */
+enum class Activity : std::uint8_t {
+  Active,   // Every tick
+  Reduced,  // Every reduced interval ticks, advancing that many ticks
+  Sleeping, // Not until woken
+  Static,   // Never
+};
+
 // Alias to represent the component ID as an unsigned integer
 using ComponentID =
     std::size_t; // std::size_t is an integer type used for counting objects
 
 /**
- * Function that generates a new unique ID for each component type.
- * Uses a static variable that is incremented at each call.
- * Returns an integer representing the component type ID.
+ * Returns the ID of the component type T: its position in ComponentTypes.
+ * Known at compile time, so using it costs nothing at run time.
  */
-inline ComponentID getNewComponentTypeID() {
-  static ComponentID lastID =
-      0u;          // Static variable: keeps its value between calls
-  return lastID++; // Returns the current value and then increments it
+template <typename T> constexpr ComponentID getComponentTypeID() noexcept {
+  static_assert(TypeListContains<T, ComponentTypes>::value,
+                "Component type missing from ComponentTypes in registry.hpp");
+  return TypeListIndex<T, ComponentTypes>::value;
 }
 
-/**
- * Template function that returns a unique ID for each component type T.
- * The ID is generated only the first time the function is called for a certain
- * type T. noexcept means the function does not throw exceptions.
- */
-template <typename T> inline ComponentID getComponentTypeID() noexcept {
-  static ComponentID typeID =
-      getNewComponentTypeID(); // Each type T will have its own static typeID
-  return typeID;
-}
+// Number of component types and groups, taken from the registry
+constexpr std::size_t maxComponents = ComponentTypes::size;
 
-// Maximum number of component types we can handle
-constexpr std::size_t maxComponents = 32;
-
-constexpr std::size_t maxGroups = 32;
+constexpr std::size_t maxGroups = groupCount;
 
 // Bitset to keep track of which components an entity has (1 = present, 0 =
 // absent)
@@ -61,19 +67,67 @@ using GroupBitset = std::bitset<maxGroups>;
 // Array of pointers to Component, one for each possible type
 using ComponentArray = std::array<Component *, maxComponents>;
 
+// One vector per component type holding every live component of that type
+template <typename List> struct ComponentStoresOf;
+
+template <typename... Ts> struct ComponentStoresOf<TypeList<Ts...>> {
+  using type = std::tuple<std::vector<Ts *>...>;
+};
+
+using ComponentStores = ComponentStoresOf<ComponentTypes>::type;
+
+/**
+ * Changes to the components of one type, for change detection. Entries are
+ * stamped with the manager's change clock; a component changed several
+ * times between two marks is listed once.
+ */
+template <typename T> struct ChangeLog {
+  struct Entry {
+    T *component;
+    std::uint64_t stamp;
+  };
+
+  std::uint64_t version = 0; // Stamp of the latest change of any T
+  std::vector<Entry> changed;
+  std::vector<Entry> added;
+  std::vector<Entry> removed; // Keys only: the components may be deleted
+};
+
+template <typename List> struct ChangeLogsOf;
+
+template <typename... Ts> struct ChangeLogsOf<TypeList<Ts...>> {
+  using type = std::tuple<ChangeLog<Ts>...>;
+};
+
+using ChangeLogs = ChangeLogsOf<ComponentTypes>::type;
+
 /**
  * Base class for all components.
  * Each component can be initialized, updated, and drawn.
  * The class is meant to be inherited.
+ *
+ * init, update and draw are not virtual: they are always called on the
+ * concrete type, which is known from the registry. A component hides the
+ * ones it needs; the empty defaults are inlined away.
+ *
+ * Every component must also be default constructible and define
+ * save(SnapshotWriter &) const and load(SnapshotReader &) for world
+ * snapshots; load restores the state and re-links the pointers init sets.
+ *
+ * Whoever writes a component reports it, through Entity::changeComponent or
+ * Entity::markChanged, so systems can visit only what changed.
  */
 class Component {
 public:
   Entity *entity; // Pointer to the entity the component belongs to
 
-  // Virtual methods: can be overridden in derived classes
-  virtual void init() {}   // Component initialization
-  virtual void update() {} // Component update logic
-  virtual void draw() {}   // Component drawing
+  // Change clock values of the last reported change and of the addition
+  std::uint64_t changedStamp = 0;
+  std::uint64_t addedStamp = 0;
+
+  void init() {}   // Component initialization
+  void update() {} // Component update logic
+  void draw() {}   // Component drawing
 
   virtual ~Component() {} // Virtual destructor for correct deletion
 };
@@ -91,35 +145,56 @@ private:
   std::vector<std::unique_ptr<Component>> components;
 
   // Array and bitset for fast access to components and checking their presence
-  ComponentArray componentArray;
+  ComponentArray componentArray{};
   ComponentBitset componentBitset;
 
   // Bitset for grouping entities
   GroupBitset groupBitset;
 
+  std::uint32_t index = 0; // Position in the manager at the last snapshot
+
+  Activity activity = Activity::Active;
+  std::uint8_t phase = 0; // Spreads reduced-rate entities over the ticks
+
+  friend class Manager; // Snapshots rebuild entities directly
+
+  // Create and attach a component, without registering or initialising it
+  template <typename T, typename... TArgs> T &emplaceComponent(TArgs &&...mArgs);
+
+  void save(SnapshotWriter &out) const; // State of every component
+  void load(SnapshotReader &in);
+
 public:
   Entity(Manager &mManager) : manager(mManager) {}
 
   /**
-   * Updates all components of the entity.
+   * Updates all components of the entity, in registry order.
    */
-  void update() {
-    for (auto &c : components) {
-      c->update();
-    }
-  }
+  void update();
 
-  void draw() {
-    for (auto &c : components) {
-      c->draw();
-    }
-  }
+  void draw(); // Draws all components of the entity, in registry order
 
   bool isActive() const {
     return active;
   } // Returns whether the entity is active
 
-  void destroy() { active = false; } // Deactivates the entity
+  // Deactivates the entity; it is removed at the next refresh
+  void destroy();
+
+  Activity getActivity() const { return activity; }
+  void setActivity(Activity mActivity);
+  void wake(); // A sleeping entity becomes active
+
+  // Whether update() runs for this entity in the current tick
+  bool isAwake() const {
+    return activity == Activity::Active || activity == Activity::Reduced;
+  }
+  bool updatesThisTick() const;
+  // Ticks one update of the entity stands for: its components scale their
+  // time-based steps by it
+  std::uint32_t ticksPerUpdate() const;
+  // The manager's tick, which snapshots save and restore
+  std::uint64_t currentTick() const;
 
   /**
    * Checks if the entity belongs to a specific group.
@@ -156,31 +231,27 @@ public:
    * @param mArgs The arguments to pass to the component constructor
    * @return A reference to the added component
    */
-  template <typename T, typename... TArgs> T &addComponent(TArgs &&...mArgs) {
-    T *c(new T(std::forward<TArgs>(mArgs)...)); // Create the component
-    c->entity = this;                           // Set the entity pointer
-    std::unique_ptr<Component> uPtr{
-        c}; // Create a unique pointer to the component
-    components.emplace_back(std::move(uPtr)); // Add the component to the entity
-
-    componentArray[getComponentTypeID<T>()] =
-        c; // Add the component to the array
-    componentBitset[getComponentTypeID<T>()] =
-        true; // Set the bit for the component
-
-    c->init(); // Initialize the component
-
-    return *c; // Return a reference to the added component
-  }
+  template <typename T, typename... TArgs> T &addComponent(TArgs &&...mArgs);
 
   /**
    * Gets a component from the entity.
    * Returns a reference to the component.
    */
   template <typename T> T &getComponent() const {
-    auto ptr(componentArray[getComponentTypeID<T>()]);
-    return *static_cast<T *>(ptr);
+    constexpr ComponentID id = getComponentTypeID<T>();
+    return *static_cast<T *>(componentArray[id]);
   }
+
+  /**
+   * Gets a component to write to it: it is reported as changed.
+   */
+  template <typename T> T &changeComponent();
+
+  // Report a change made through a pointer kept elsewhere
+  template <typename T> void markChanged();
+
+  // How snapshots refer to the entity; valid during Manager::save and load
+  std::uint32_t snapshotIndex() const { return index; }
 };
 
 class Manager {
@@ -190,12 +261,114 @@ private:
 
   std::array<std::vector<Entity *>, maxGroups> groupedEntities;
 
+  ComponentStores stores; // Live components, one vector per type
+
+  // An entity was destroyed or left a group since the last refresh
+  bool needsRefresh = false;
+
+  // The stores without the components of static and sleeping entities:
+  // update() walks these, rebuilt when an entity falls asleep or wakes
+  ComponentStores awake;
+  bool awakeChanged = true;
+
+  std::uint64_t tick = 0;
+  std::uint32_t reducedInterval = 1;
+
+  // What a timer of addTimer fires; entity may be nullptr
+  struct EntityTimer {
+    Entity *entity;
+    std::uint32_t tag;
+  };
+  TimerWheel<EntityTimer> timers; // Clocked by tick
+
+  void rebuildAwake();
+
+  // Change detection: stamps come from changeClock, which changeMark()
+  // advances. The logs hold the changes of the last two ticks.
+  ChangeLogs changeLogs;
+  std::uint64_t changeClock = 1;
+  std::uint64_t logFloor = 0;    // The logs hold every change after it
+  std::uint64_t lastEndClock = 0;
+  std::uint64_t rebuiltStamp = 1; // Clock of the last snapshot load
+
+  template <typename T> ChangeLog<T> &changeLog() {
+    return std::get<ChangeLog<T>>(changeLogs);
+  }
+
 public:
-  void update() {
-    for (auto &e : entities)
-      e->update();
+  /**
+   * Updates every component, one type at a time in registry order.
+   * Each loop calls the concrete type directly: no virtual dispatch.
+   * Static and sleeping entities are not visited at all; reduced-rate ones
+   * only on their ticks.
+   */
+  void update();
+
+  void beginTick(); // Before anything of the tick updates; fires timers
+  std::uint64_t currentTick() const { return tick; }
+
+  /**
+   * Timers. After delay ticks (at least one), then every period ticks if
+   * period is not 0, the timer emits TimerEvent{entity, tag} at the start
+   * of its tick, before any component updates. Delayed spawns, cooldowns
+   * and respawns wait on a timer instead of counting down every tick.
+   * Timers are saved with the world and cancelled with their entity.
+   */
+  TimerId addTimer(Entity *entity, std::uint32_t delay, std::uint32_t tag,
+                   std::uint32_t period = 0) {
+    return timers.Schedule(tick + delay, {entity, tag}, period);
+  }
+  bool cancelTimer(TimerId id) { return timers.Cancel(id); }
+  bool rescheduleTimer(TimerId id, std::uint32_t delay) {
+    return timers.Reschedule(id, tick + delay);
+  }
+  bool timerPending(TimerId id) const { return timers.IsPending(id); }
+  std::size_t timerCount() const { return timers.Size(); }
+
+  void setReducedInterval(std::uint32_t interval);
+  std::uint32_t getReducedInterval() const { return reducedInterval; }
+
+  void markAwakeChanged() { awakeChanged = true; }
+
+  /**
+   * Change detection. A system keeps the mark of its previous run and asks
+   * for what changed since:
+   *
+   *   manager.forEachChanged<T>(mark, ...);
+   *   mark = manager.changeMark();
+   *
+   * Taking the new mark before the pass instead makes the system see its
+   * own writes again on the next run. Systems that run less than once per
+   * tick get changed components from a scan of the store instead of the
+   * log, and miss removals.
+   */
+  std::uint64_t changeMark() { return changeClock++; }
+
+  template <typename T> void markChanged(T &component);
+  template <typename T> void markAdded(T &component);
+  template <typename T> void markRemoved(T &component);
+
+  // Whether any T changed since the mark, without visiting them
+  template <typename T> bool anyChangedSince(std::uint64_t since) {
+    return changeLog<T>().version > since;
   }
 
+  // f must not report changes to T itself
+  template <typename T, typename F>
+  void forEachChanged(std::uint64_t since, F &&f);
+  template <typename T, typename F>
+  void forEachAdded(std::uint64_t since, F &&f);
+  // Components of entities destroyed since the mark. The pointers identify
+  // them but must not be dereferenced: they may already be deleted.
+  template <typename T, typename F>
+  void forEachRemoved(std::uint64_t since, F &&f);
+
+  // A snapshot was loaded since the mark: every component may have been
+  // replaced, so state derived from them must be rebuilt from the stores
+  bool rebuiltSince(std::uint64_t since) const { return rebuiltStamp > since; }
+
+  void endTick(); // Drop the changes older than the previous tick
+
   void draw() {
     for (auto &e : entities)
       e->draw();
@@ -204,28 +377,11 @@ public:
   /**
    * Removes inactive entities from the entities vector.
    * This function is used to clean up inactive entities.
+   * Does nothing on ticks where no entity was destroyed or ungrouped.
    */
-  void refresh() {
-
-    /**
-     * Remove inactive entities from each group.
-     */
-    for (auto i(0u); i < maxGroups; i++) {
-      auto &v(groupedEntities[i]);
-      v.erase(std::remove_if(std::begin(v), std::end(v),
-                             [i](Entity *mEntity) {
-                               return !mEntity->isActive() ||
-                                      !mEntity->hasGroup(i);
-                             }),
-              std::end(v));
-    }
+  void refresh();
 
-    entities.erase(std::remove_if(std::begin(entities), std::end(entities),
-                                  [](const std::unique_ptr<Entity> &mEntity) {
-                                    return !mEntity->isActive();
-                                  }),
-                   std::end(entities));
-  }
+  void markForRefresh() { needsRefresh = true; }
 
   /**
    * Adds an entity to a group.
@@ -248,12 +404,188 @@ public:
    */
   Entity &addEntity() {
     Entity *e = new Entity(*this);
+    e->phase = static_cast<std::uint8_t>(entities.size());
     std::unique_ptr<Entity> uPtr{e}; // Create a unique pointer to the entity
     entities.emplace_back(
         std::move(uPtr)); // Add the entity to the entities vector
 
+    EventBus::Emit(EntitySpawnedEvent{e});
+
     return *e; // Return a reference to the added entity
   }
+
+  /**
+   * Spawn count entities from a prefab, a component type at a time;
+   * initialiser(Entity &, std::size_t i) runs on each before init().
+   * Defined in prefab.hpp.
+   */
+  template <typename F>
+  void spawnBatch(const Prefab &prefab, std::size_t count, F &&initialiser);
+  void spawnBatch(const Prefab &prefab, std::size_t count);
+
+  /**
+   * Gets every live component of type T
+   */
+  template <typename T> std::vector<T *> &getComponents() {
+    return std::get<std::vector<T *>>(stores);
+  }
+
+  /**
+   * Write every entity, its groups and components, the order of the
+   * groups and component stores, and the pending timers.
+   */
+  void save(SnapshotWriter &out);
+
+  /**
+   * Rebuild the world written by save(). Entities are matched by position:
+   * one with the same component types is kept and overwritten, any other is
+   * replaced by a new entity. Returns false if the data runs short, which
+   * may leave the world partly loaded: WorldSnapshot::Restore checks the
+   * data is whole first.
+   */
+  bool load(SnapshotReader &in);
+
+  std::size_t entityCount() const { return entities.size(); }
+
+  // Log the entity count and the memory held per component type
+  void reportMemory() const;
 };
 
+inline bool Entity::updatesThisTick() const {
+  switch (activity) {
+  case Activity::Active:
+    return true;
+  case Activity::Reduced:
+    return (manager.currentTick() + phase) % manager.getReducedInterval() ==
+           0;
+  default:
+    return false;
+  }
+}
+
+inline std::uint32_t Entity::ticksPerUpdate() const {
+  return activity == Activity::Reduced ? manager.getReducedInterval() : 1;
+}
+
+inline std::uint64_t Entity::currentTick() const {
+  return manager.currentTick();
+}
+
+template <typename T> T &Entity::changeComponent() {
+  T &c = getComponent<T>();
+  manager.markChanged(c);
+  return c;
+}
+
+template <typename T> void Entity::markChanged() {
+  manager.markChanged(getComponent<T>());
+}
+
+template <typename T> void Manager::markChanged(T &component) {
+  auto &log = changeLog<T>();
+  log.version = changeClock;
+  if (component.changedStamp != changeClock) {
+    component.changedStamp = changeClock;
+    log.changed.push_back({&component, changeClock});
+  }
+}
+
+template <typename T> void Manager::markAdded(T &component) {
+  component.addedStamp = changeClock;
+  changeLog<T>().added.push_back({&component, changeClock});
+  markChanged(component);
+}
+
+template <typename T> void Manager::markRemoved(T &component) {
+  auto &log = changeLog<T>();
+  log.version = changeClock;
+  log.removed.push_back({&component, changeClock});
+}
+
+template <typename T, typename F>
+void Manager::forEachChanged(std::uint64_t since, F &&f) {
+  auto &log = changeLog<T>();
+  if (log.version <= since) {
+    return;
+  }
+  if (since < logFloor) {
+    for (T *c : getComponents<T>()) {
+      if (c->changedStamp > since) {
+        f(*c);
+      }
+    }
+    return;
+  }
+  // A component changed again later has a newer entry: visit that one
+  for (const auto &entry : log.changed) {
+    if (entry.stamp > since && entry.component->changedStamp == entry.stamp) {
+      f(*entry.component);
+    }
+  }
+}
+
+template <typename T, typename F>
+void Manager::forEachAdded(std::uint64_t since, F &&f) {
+  if (since < logFloor) {
+    for (T *c : getComponents<T>()) {
+      if (c->addedStamp > since) {
+        f(*c);
+      }
+    }
+    return;
+  }
+  for (const auto &entry : changeLog<T>().added) {
+    if (entry.stamp > since) {
+      f(*entry.component);
+    }
+  }
+}
+
+template <typename T, typename F>
+void Manager::forEachRemoved(std::uint64_t since, F &&f) {
+  for (const auto &entry : changeLog<T>().removed) {
+    if (entry.stamp > since) {
+      f(static_cast<const T *>(entry.component));
+    }
+  }
+}
+
+/**
+ * Adds a component to the entity.
+ * The component is created with the given arguments and added to the entity.
+ * T must be listed in ComponentTypes.
+ * @tparam T The type of the component to add
+ * @tparam TArgs The types of the arguments to pass to the component
+ * constructor
+ * @param mArgs The arguments to pass to the component constructor
+ * @return A reference to the added component
+ */
+template <typename T, typename... TArgs>
+T &Entity::addComponent(TArgs &&...mArgs) {
+  T &c = emplaceComponent<T>(std::forward<TArgs>(mArgs)...);
+  manager.getComponents<T>().push_back(&c); // Add it to the typed store
+  manager.markAwakeChanged();
+  manager.markAdded(c);
+
+  c.init(); // Initialize the component
+
+  return c; // Return a reference to the added component
+}
+
+template <typename T, typename... TArgs>
+T &Entity::emplaceComponent(TArgs &&...mArgs) {
+  constexpr ComponentID id = getComponentTypeID<T>();
+
+  T *c(new T(std::forward<TArgs>(mArgs)...)); // Create the component
+  c->entity = this;                           // Set the entity pointer
+  std::unique_ptr<Component> uPtr{
+      c}; // Create a unique pointer to the component
+  components.emplace_back(std::move(uPtr)); // Add the component to the entity
+
+  componentArray[id] = c;     // Add the component to the array
+  componentBitset[id] = true; // Set the bit for the component
+
+  return *c;
+}
+
 #endif
\ No newline at end of file
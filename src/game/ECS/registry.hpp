@@ -0,0 +1,77 @@
+// registry.hpp
+// Compile-time registry of the ECS.
+// Every component type and entity group is listed here. IDs, bitset sizes
+// and the per-type component stores are all derived from these lists, so
+// adding a type means adding it to ComponentTypes and nothing else.
+#ifndef REGISTRY_HPP
+#define REGISTRY_HPP
+
+#include <cstddef>
+#include <type_traits>
+
+/**
+ * A list of types, only ever used at compile time
+ */
+template <typename... Ts> struct TypeList {
+  static constexpr std::size_t size = sizeof...(Ts);
+};
+
+// Whether T is in List
+template <typename T, typename List> struct TypeListContains;
+
+template <typename T, typename... Ts>
+struct TypeListContains<T, TypeList<Ts...>>
+    : std::bool_constant<(std::is_same_v<T, Ts> || ...)> {};
+
+// Position of T in List; T must be in it
+template <typename T, typename List> struct TypeListIndex;
+
+template <typename T, typename... Ts>
+struct TypeListIndex<T, TypeList<T, Ts...>>
+    : std::integral_constant<std::size_t, 0> {};
+
+template <typename T, typename U, typename... Ts>
+struct TypeListIndex<T, TypeList<U, Ts...>>
+    : std::integral_constant<std::size_t,
+                             1 + TypeListIndex<T, TypeList<Ts...>>::value> {};
+
+class TransformComponent;
+class SpriteComponent;
+class KeyboardController;
+class ColliderComponent;
+class TileComponent;
+class FollowDelayComponent;
+class ParticleEmitterComponent;
+class NavigationComponent;
+class BehaviourComponent;
+
+/**
+ * Every component type. The order is the order in which Manager::update and
+ * Entity::draw visit them: transforms first, then what reads them.
+ */
+using ComponentTypes =
+    TypeList<TransformComponent, SpriteComponent, KeyboardController,
+             ColliderComponent, TileComponent, FollowDelayComponent,
+             ParticleEmitterComponent, NavigationComponent,
+             BehaviourComponent>;
+
+// Names of ComponentTypes, in the same order, for reports
+constexpr const char *componentNames[] = {
+    "Transform", "Sprite",     "Keyboard",        "Collider",
+    "Tile",      "FollowDelay", "ParticleEmitter", "Navigation",
+    "Behaviour",
+};
+
+static_assert(sizeof(componentNames) / sizeof(componentNames[0]) ==
+                  ComponentTypes::size,
+              "One name per component type");
+
+// Entity groups
+enum groupLabels : std::size_t {
+  groupMap,
+  groupPlayers,
+  groupColliders,
+  groupCount, // Keep last
+};
+
+#endif
@@ -0,0 +1,367 @@
+#include "behaviour.hpp"
+#include "../../utility/framePool/frame_pool.hpp"
+#include "../../utility/logger/logger.hpp"
+#include "../ECS/ECS.hpp"
+#include "../components/transformComponent/transform_component.hpp"
+#include "../timerWheel/timer_wheel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <exception>
+
+namespace {
+
+enum class Wait : std::uint8_t { None, Tick, Timer, Event, Reached };
+
+struct Slot {
+  Behaviour::Handle handle;
+  std::uint32_t generation = 0;
+  Wait wait = Wait::None;
+  TimerId timer; // While waiting for ticks
+};
+
+struct ReachWaiter {
+  TransformComponent *transform;
+  BehaviourId id;
+  Vector2D target;
+  float radiusSquared;
+};
+
+// Storage reserved for this many waiting behaviours before growing
+constexpr std::size_t reservedBehaviours = 256;
+
+struct State {
+  std::vector<Slot> slots;
+  std::vector<std::uint32_t> freeSlots;
+
+  std::vector<BehaviourId> nextTick; // Resumed by the next Update
+  std::vector<BehaviourId> due;      // Being resumed by this Update
+  // Clocked by the updates, not the manager's tick, which goes back when
+  // a snapshot is loaded
+  TimerWheel<BehaviourId> timers;
+  EventWaiters events;
+  std::vector<ReachWaiter> reached; // Sorted by transform
+
+  std::uint64_t changeMark = 0; // Transforms changed after it are checked
+  std::size_t running = 0;
+  std::size_t resumed = 0;
+
+  State() {
+    reserve(reservedBehaviours);
+    std::apply([](auto &...waiters) { (waiters.reserve(reservedBehaviours), ...); },
+               events);
+  }
+
+  // Every behaviour waits in one list at a time: with room for all of them
+  // in the lists of the common waits, those never grow while behaviours run.
+  // Event waits are few and keep their first reservation.
+  void reserve(std::size_t behaviours) {
+    slots.reserve(behaviours);
+    freeSlots.reserve(behaviours);
+    nextTick.reserve(behaviours);
+    due.reserve(behaviours);
+    timers.Reserve(behaviours);
+    reached.reserve(behaviours);
+  }
+};
+
+// Never destroyed: components stop their behaviours from their destructors,
+// which may run after the statics of this file are gone
+State &state() {
+  static State *s = new State;
+  return *s;
+}
+
+bool valid(const State &s, BehaviourId id) {
+  return id.generation != 0 && id.slot < s.slots.size() &&
+         s.slots[id.slot].generation == id.generation;
+}
+
+void finish(State &s, std::uint32_t slot) {
+  Slot &entry = s.slots[slot];
+  entry.handle.destroy();
+  entry.handle = nullptr;
+  entry.wait = Wait::None;
+  entry.generation = entry.generation + 1 == 0 ? 1 : entry.generation + 1;
+  s.freeSlots.push_back(slot);
+  s.running--;
+}
+
+// Resume the waiters of every event of type E emitted this tick, each with
+// the first event about its entity
+template <typename E>
+void wakeOnEvents(State &s, std::vector<EventWaiter<E>> &waiters) {
+  if (waiters.empty()) {
+    return;
+  }
+
+  for (const E &e : EventBus::Events<E>()) {
+    auto range = std::equal_range(
+        waiters.begin(), waiters.end(), EventWaiter<E>{e.entity, {}, nullptr},
+        [](const EventWaiter<E> &a, const EventWaiter<E> &b) {
+          return a.entity < b.entity;
+        });
+    for (auto it = range.first; it != range.second; ++it) {
+      *it->result = e;
+      s.due.push_back(it->id);
+    }
+    waiters.erase(range.first, range.second);
+  }
+}
+
+template <typename E>
+void eraseWaiter(std::vector<EventWaiter<E>> &waiters, BehaviourId id) {
+  waiters.erase(std::remove_if(waiters.begin(), waiters.end(),
+                               [id](const EventWaiter<E> &w) {
+                                 return w.id.slot == id.slot &&
+                                        w.id.generation == id.generation;
+                               }),
+                waiters.end());
+}
+
+// Within the radius, or within the step the entity takes at its update rate
+// when checked: a step that long can not pass the target over, even if the
+// rate changed after the behaviour suspended
+bool within(const TransformComponent &transform, const Vector2D &target,
+            float radiusSquared) {
+  const float step = static_cast<float>(transform.speed) *
+                     static_cast<float>(transform.entity->ticksPerUpdate());
+  const float dx = transform.position.x - target.x;
+  const float dy = transform.position.y - target.y;
+  return dx * dx + dy * dy <= std::max(radiusSquared, step * step);
+}
+
+} // namespace
+
+void Behaviour::promise_type::unhandled_exception() {
+  LOG_ERROR("Unhandled exception in a behaviour");
+  std::terminate();
+}
+
+void *Behaviour::promise_type::operator new(std::size_t size) {
+  return FramePool::Allocate(size);
+}
+
+void Behaviour::promise_type::operator delete(void *frame, std::size_t size) {
+  FramePool::Free(frame, size);
+}
+
+Behaviour &Behaviour::operator=(Behaviour &&other) noexcept {
+  if (this != &other) {
+    if (handle) {
+      handle.destroy();
+    }
+    handle = other.handle;
+    other.handle = nullptr;
+  }
+  return *this;
+}
+
+// A behaviour never started still owns its frame
+Behaviour::~Behaviour() {
+  if (handle) {
+    handle.destroy();
+  }
+}
+
+TicksAwaiter seconds(float duration) {
+  if (duration <= 0.0f) {
+    return {0};
+  }
+  const long count = std::lround(duration / behaviourTickSeconds);
+  return {static_cast<std::uint32_t>(std::max(count, 1L))};
+}
+
+bool ReachedAwaiter::await_suspend(Behaviour::Handle h) const {
+  Entity *entity = h.promise().entity;
+  if (!entity->hasComponent<TransformComponent>()) {
+    return false; // Nothing to wait for
+  }
+  return BehaviourScheduler::WaitReached(
+      h.promise().id, &entity->getComponent<TransformComponent>(), target,
+      radius);
+}
+
+BehaviourId BehaviourScheduler::Start(Entity &entity, Behaviour behaviour) {
+  State &s = state();
+
+  std::uint32_t slot;
+  if (!s.freeSlots.empty()) {
+    slot = s.freeSlots.back();
+    s.freeSlots.pop_back();
+  } else {
+    // Grown here, when behaviours start, rather than in Update()
+    if (s.slots.size() == s.slots.capacity()) {
+      s.reserve(s.slots.capacity() * 2);
+    }
+    slot = static_cast<std::uint32_t>(s.slots.size());
+    s.slots.push_back({nullptr, 1, Wait::None, {}});
+  }
+
+  Slot &entry = s.slots[slot];
+  entry.handle = behaviour.handle;
+  behaviour.handle = nullptr; // The scheduler owns the frame now
+
+  const BehaviourId id = {slot, entry.generation};
+  entry.handle.promise().id = id;
+  entry.handle.promise().entity = &entity;
+  s.running++;
+
+  WaitNextTick(id);
+  return id;
+}
+
+void BehaviourScheduler::Stop(BehaviourId id) {
+  State &s = state();
+  if (!valid(s, id)) {
+    return;
+  }
+
+  // Entries in the next tick list are skipped once the generation has
+  // moved on; the other waits are cancelled now
+  switch (s.slots[id.slot].wait) {
+  case Wait::Timer:
+    s.timers.Cancel(s.slots[id.slot].timer);
+    break;
+  case Wait::Event:
+    std::apply([id](auto &...waiters) { (eraseWaiter(waiters, id), ...); },
+               s.events);
+    break;
+  case Wait::Reached:
+    s.reached.erase(std::remove_if(s.reached.begin(), s.reached.end(),
+                                   [id](const ReachWaiter &w) {
+                                     return w.id.slot == id.slot &&
+                                            w.id.generation == id.generation;
+                                   }),
+                    s.reached.end());
+    break;
+  default:
+    break;
+  }
+
+  finish(s, id.slot);
+}
+
+bool BehaviourScheduler::IsRunning(BehaviourId id) {
+  return valid(state(), id);
+}
+
+/**
+ * Resume every behaviour whose wait is over: those waiting for this tick,
+ * the timers due, the events of this tick, then the positions reached.
+ * @param manager Its tick clock and transform changes drive the waits
+ */
+void BehaviourScheduler::Update(Manager &manager) {
+  State &s = state();
+
+  s.due.clear();
+  s.due.swap(s.nextTick);
+
+  s.timers.Advance(s.timers.Now() + 1,
+                   [&s](TimerId, BehaviourId id) { s.due.push_back(id); });
+
+  std::apply([&s](auto &...waiters) { (wakeOnEvents(s, waiters), ...); },
+             s.events);
+
+  // Only transforms that changed since the last update can have arrived
+  if (!s.reached.empty()) {
+    bool arrived = false;
+    manager.forEachChanged<TransformComponent>(
+        s.changeMark, [&s, &arrived](TransformComponent &transform) {
+          auto range = std::equal_range(
+              s.reached.begin(), s.reached.end(),
+              ReachWaiter{&transform, {}, {}, 0.0f},
+              [](const ReachWaiter &a, const ReachWaiter &b) {
+                return a.transform < b.transform;
+              });
+          for (auto it = range.first; it != range.second; ++it) {
+            if (within(transform, it->target, it->radiusSquared)) {
+              s.due.push_back(it->id);
+              it->transform = nullptr;
+              arrived = true;
+            }
+          }
+        });
+    if (arrived) {
+      s.reached.erase(std::remove_if(s.reached.begin(), s.reached.end(),
+                                     [](const ReachWaiter &w) {
+                                       return w.transform == nullptr;
+                                     }),
+                      s.reached.end());
+    }
+  }
+  // Moves made by the behaviours below are checked at the next update
+  s.changeMark = manager.changeMark();
+
+  s.resumed = 0;
+  for (std::size_t i = 0; i < s.due.size(); i++) {
+    const BehaviourId id = s.due[i];
+    if (!valid(s, id)) {
+      continue; // Stopped while it waited
+    }
+
+    // Resuming may start behaviours and grow the slots: no reference is
+    // kept across it
+    s.slots[id.slot].wait = Wait::None;
+    const Behaviour::Handle handle = s.slots[id.slot].handle;
+    handle.resume();
+    s.resumed++;
+
+    if (handle.done()) {
+      finish(s, id.slot);
+    }
+  }
+}
+
+void BehaviourScheduler::Clear() {
+  State &s = state();
+  for (std::uint32_t slot = 0; slot < s.slots.size(); slot++) {
+    if (s.slots[slot].handle) {
+      finish(s, slot);
+    }
+  }
+  s.nextTick.clear();
+  s.due.clear();
+  s.timers.Reset(s.timers.Now());
+  std::apply([](auto &...waiters) { (waiters.clear(), ...); }, s.events);
+  s.reached.clear();
+}
+
+std::size_t BehaviourScheduler::Running() { return state().running; }
+
+std::size_t BehaviourScheduler::ResumedLastTick() { return state().resumed; }
+
+void BehaviourScheduler::WaitNextTick(BehaviourId id) {
+  State &s = state();
+  s.slots[id.slot].wait = Wait::Tick;
+  s.nextTick.push_back(id);
+}
+
+void BehaviourScheduler::WaitTicks(BehaviourId id, std::uint32_t ticks) {
+  State &s = state();
+  s.slots[id.slot].wait = Wait::Timer;
+  s.slots[id.slot].timer = s.timers.Schedule(s.timers.Now() + ticks, id);
+}
+
+bool BehaviourScheduler::WaitReached(BehaviourId id,
+                                     TransformComponent *transform,
+                                     const Vector2D &target, float radius) {
+  const float radiusSquared = radius * radius;
+  if (within(*transform, target, radiusSquared)) {
+    return false;
+  }
+
+  State &s = state();
+  s.slots[id.slot].wait = Wait::Reached;
+  auto at = std::upper_bound(s.reached.begin(), s.reached.end(), transform,
+                             [](TransformComponent *t, const ReachWaiter &w) {
+                               return t < w.transform;
+                             });
+  s.reached.insert(at, {transform, id, target, radiusSquared});
+  return true;
+}
+
+EventWaiters &BehaviourScheduler::eventWaitersAll() { return state().events; }
+
+void BehaviourScheduler::waitingOnEvent(BehaviourId id) {
+  state().slots[id.slot].wait = Wait::Event;
+}
@@ -0,0 +1,222 @@
+// behaviour.hpp
+// Coroutine behaviours: entity logic written as straight-line code that
+// suspends while it waits, instead of a component polled every tick.
+//
+//   Behaviour Guard(Entity &self) {
+//     while (true) {
+//       const CollisionEvent hit = co_await event<CollisionEvent>();
+//       ...
+//       co_await seconds(2.0f);
+//     }
+//   }
+#ifndef BEHAVIOUR_HPP
+#define BEHAVIOUR_HPP
+
+#include "../eventBus/event_bus.hpp"
+#include "../vector2d/vector_2d.hpp"
+#include <algorithm>
+#include <coroutine>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+class Entity;
+class Manager;
+class TransformComponent;
+
+// Simulated time of one tick: the game ticks once per frame at 60 FPS
+constexpr float behaviourTickSeconds = 1.0f / 60.0f;
+
+/**
+ * Names a started behaviour. A slot is reused once its behaviour ends, with
+ * a new generation, so an old id never refers to another behaviour.
+ */
+struct BehaviourId {
+  std::uint32_t slot = 0;
+  std::uint32_t generation = 0; // 0: no behaviour
+};
+
+/**
+ * Behaviour class
+ *
+ * Return type of a behaviour coroutine. The body does not run until the
+ * behaviour is handed to BehaviourScheduler::Start; the scheduler then owns
+ * the frame. Frames come from the FramePool.
+ */
+class Behaviour {
+public:
+  struct promise_type {
+    BehaviourId id;           // Set by BehaviourScheduler::Start
+    Entity *entity = nullptr; // The entity the behaviour runs for
+
+    Behaviour get_return_object() {
+      return Behaviour(
+          std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception();
+
+    static void *operator new(std::size_t size);
+    static void operator delete(void *frame, std::size_t size);
+  };
+
+  using Handle = std::coroutine_handle<promise_type>;
+
+  Behaviour(Behaviour &&other) noexcept : handle(other.handle) {
+    other.handle = nullptr;
+  }
+  Behaviour &operator=(Behaviour &&other) noexcept;
+  Behaviour(const Behaviour &) = delete;
+  Behaviour &operator=(const Behaviour &) = delete;
+  ~Behaviour();
+
+private:
+  friend class BehaviourScheduler;
+
+  explicit Behaviour(Handle handle) : handle(handle) {}
+
+  Handle handle;
+};
+
+// Waiting for an event of type E about the behaviour's entity
+template <typename E> struct EventWaiter {
+  Entity *entity;
+  BehaviourId id;
+  E *result; // In the suspended frame
+};
+
+template <typename List> struct EventWaitersOf;
+
+template <typename... Ts> struct EventWaitersOf<TypeList<Ts...>> {
+  using type = std::tuple<std::vector<EventWaiter<Ts>>...>;
+};
+
+using EventWaiters = EventWaitersOf<EventTypes>::type;
+
+/**
+ * BehaviourScheduler class
+ *
+ * Runs behaviours. A suspended behaviour sits in the list of what it waits
+ * for and costs nothing until that happens:
+ * - the next tick: a list resumed as a whole;
+ * - a number of ticks: a timing wheel;
+ * - an event: per event type, a list sorted by entity, searched once per
+ *   event emitted this tick;
+ * - a position: found through the transforms the manager reports as
+ *   changed, so behaviours of entities that do not move are never visited.
+ *
+ * Update() resumes everything that became due, in that order, once per
+ * tick. The cost of a tick follows the behaviours that wake, not the ones
+ * that exist. Events a behaviour emits reach the systems that run after
+ * Update(), not the other behaviours' waits.
+ *
+ * Simulation thread only (or before the simulation thread starts).
+ *
+ * @author: @iMeyu
+ */
+class BehaviourScheduler {
+public:
+  // The behaviour's first step runs at the next Update()
+  static BehaviourId Start(Entity &entity, Behaviour behaviour);
+  // End a behaviour other than the running one; ids that ended are ignored
+  static void Stop(BehaviourId id);
+  static bool IsRunning(BehaviourId id);
+
+  static void Update(Manager &manager); // After this tick's events
+  static void Clear();                  // End every behaviour
+
+  static std::size_t Running();
+  static std::size_t ResumedLastTick();
+
+  // Called by the awaitables, with the id of the suspending behaviour
+  static void WaitNextTick(BehaviourId id);
+  static void WaitTicks(BehaviourId id, std::uint32_t ticks);
+  template <typename E>
+  static void WaitEvent(BehaviourId id, Entity *entity, E *result);
+  // false if the transform is already there: the behaviour goes on
+  static bool WaitReached(BehaviourId id, TransformComponent *transform,
+                          const Vector2D &target, float radius);
+
+private:
+  template <typename E> static std::vector<EventWaiter<E>> &eventWaiters() {
+    return std::get<std::vector<EventWaiter<E>>>(eventWaitersAll());
+  }
+  static EventWaiters &eventWaitersAll();
+  static void waitingOnEvent(BehaviourId id);
+};
+
+template <typename E>
+void BehaviourScheduler::WaitEvent(BehaviourId id, Entity *entity, E *result) {
+  static_assert(TypeListContains<E, EventTypes>::value,
+                "Event type missing from EventTypes in events.hpp");
+
+  // Kept sorted by entity; equal entities keep the order they waited in
+  auto &waiters = eventWaiters<E>();
+  auto at = std::upper_bound(
+      waiters.begin(), waiters.end(), entity,
+      [](Entity *e, const EventWaiter<E> &w) { return e < w.entity; });
+  waiters.insert(at, {entity, id, result});
+  waitingOnEvent(id);
+}
+
+/**
+ * Awaitables. Each one hands the suspending behaviour to the scheduler.
+ */
+struct NextTickAwaiter {
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(Behaviour::Handle h) const {
+    BehaviourScheduler::WaitNextTick(h.promise().id);
+  }
+  void await_resume() const noexcept {}
+};
+
+struct TicksAwaiter {
+  std::uint32_t ticks;
+
+  bool await_ready() const noexcept { return ticks == 0; }
+  void await_suspend(Behaviour::Handle h) const {
+    BehaviourScheduler::WaitTicks(h.promise().id, ticks);
+  }
+  void await_resume() const noexcept {}
+};
+
+template <typename E> struct EventAwaiter {
+  E result{};
+
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(Behaviour::Handle h) {
+    BehaviourScheduler::WaitEvent(h.promise().id, h.promise().entity,
+                                  &result);
+  }
+  E await_resume() const noexcept { return result; }
+};
+
+struct ReachedAwaiter {
+  Vector2D target;
+  float radius;
+
+  bool await_ready() const noexcept { return false; }
+  bool await_suspend(Behaviour::Handle h) const;
+  void await_resume() const noexcept {}
+};
+
+// Resume at the next tick
+inline NextTickAwaiter nextTick() { return {}; }
+
+// Resume after this many ticks, or simulated seconds (at least one tick
+// unless 0)
+inline TicksAwaiter ticks(std::uint32_t count) { return {count}; }
+TicksAwaiter seconds(float duration);
+
+// Resume with the next event of type E whose entity is the behaviour's
+template <typename E> EventAwaiter<E> event() { return {}; }
+
+// Resume once the entity's transform is within radius of target, or within
+// the step it moves per update at that time
+inline ReachedAwaiter untilReached(const Vector2D &target, float radius) {
+  return {target, radius};
+}
+
+#endif
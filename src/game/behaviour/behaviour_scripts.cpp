@@ -0,0 +1,64 @@
+#include "behaviour_scripts.hpp"
+#include "../ECS/ECS.hpp"
+#include "../components/behaviourComponent/behaviour_component.hpp"
+#include "../components/transformComponent/transform_component.hpp"
+
+namespace {
+
+constexpr float patrolDistance = 128.0f;
+constexpr float patrolRestSeconds = 1.0f;
+
+// A resumed script sets the velocity the snapshot already holds: nothing
+// changes then, and no event is emitted
+void setVelocity(Entity &self, TransformComponent &transform,
+                 const Vector2D &velocity) {
+  if (transform.velocity == velocity) {
+    return;
+  }
+  transform.velocity = velocity;
+  self.markChanged<TransformComponent>();
+  EventBus::Emit(MovementChangedEvent{&self, velocity != Vector2D(0.0f, 0.0f)});
+}
+
+} // namespace
+
+void BehaviourScripts::RegisterAll() {
+  BehaviourComponent::RegisterScript("patrol", &BehaviourScripts::Patrol);
+}
+
+Behaviour BehaviourScripts::Patrol(Entity &self) {
+  auto &transform = self.getComponent<TransformComponent>();
+  // Resumed from here after a snapshot is loaded: stage is the end walked
+  // to, untilTick the end of the rest before it
+  auto &progress = self.getComponent<BehaviourComponent>().progress;
+  if (!progress.started) {
+    progress.started = true;
+    progress.stage = 1;
+    progress.untilTick = 0;
+    progress.anchor = transform.position;
+  }
+  const Vector2D ends[2] = {
+      progress.anchor,
+      progress.anchor + Vector2D(patrolDistance, 0.0f),
+  };
+  const std::uint32_t restTicks = seconds(patrolRestSeconds).ticks;
+
+  for (;;) {
+    if (progress.untilTick != 0) {
+      const std::uint64_t now = self.currentTick();
+      if (progress.untilTick > now) {
+        co_await ticks(static_cast<std::uint32_t>(progress.untilTick - now));
+      }
+      progress.untilTick = 0;
+    }
+
+    const float direction = progress.stage == 1 ? 1.0f : -1.0f;
+    setVelocity(self, transform, Vector2D(direction, 0.0f));
+    // Reached within the step of whatever rate the entity updates at
+    co_await untilReached(ends[progress.stage], 0.0f);
+
+    setVelocity(self, transform, Vector2D(0.0f, 0.0f));
+    progress.stage = 1 - progress.stage;
+    progress.untilTick = self.currentTick() + restTicks;
+  }
+}
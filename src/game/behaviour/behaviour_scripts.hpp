@@ -0,0 +1,24 @@
+#ifndef BEHAVIOUR_SCRIPTS_HPP
+#define BEHAVIOUR_SCRIPTS_HPP
+
+#include "behaviour.hpp"
+
+class Entity;
+
+/**
+ * BehaviourScripts class
+ *
+ * The behaviour scripts the game ships, registered by name for
+ * BehaviourComponent.
+ *
+ * @author: @iMeyu
+ */
+class BehaviourScripts {
+public:
+  static void RegisterAll();
+
+  // Walk to a point a few tiles to the right and back, resting at each end
+  static Behaviour Patrol(Entity &self);
+};
+
+#endif
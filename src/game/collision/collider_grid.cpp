@@ -0,0 +1,196 @@
+#include "collider_grid.hpp"
+#include "../ECS/ECS.hpp"
+#include "../components/colliderComponent/collider_component.hpp"
+#include <algorithm>
+
+namespace {
+
+// Colliders a cell holds before its list grows: a terrain collider and a
+// few moving ones passing through
+constexpr std::size_t cellCapacity = 4;
+
+// Colliders a query gathers before its scratch grows
+constexpr std::size_t queryCapacity = 64;
+
+} // namespace
+
+void ColliderGrid::SetGrid(int w, int h, int size) {
+  width = std::max(w, 1);
+  height = std::max(h, 1);
+  cellSize = size > 0 ? size : 1;
+
+  cells.assign(static_cast<std::size_t>(width) * height, {});
+  for (auto &cell : cells) {
+    cell.reserve(cellCapacity);
+  }
+  placed.clear();
+  found.reserve(queryCapacity);
+  nextOrder = 0;
+  mark = 0; // The next update rebuilds
+}
+
+ColliderGrid::Placement ColliderGrid::cover(const SDL_Rect &rect) const {
+  // Negative coordinates divide toward zero, then clamp to the first cell
+  auto cellX = [this](int x) { return std::clamp(x / cellSize, 0, width - 1); };
+  auto cellY = [this](int y) {
+    return std::clamp(y / cellSize, 0, height - 1);
+  };
+
+  Placement p;
+  p.x0 = cellX(rect.x);
+  p.y0 = cellY(rect.y);
+  p.x1 = cellX(rect.x + std::max(rect.w, 1) - 1);
+  p.y1 = cellY(rect.y + std::max(rect.h, 1) - 1);
+  p.order = 0;
+  return p;
+}
+
+void ColliderGrid::link(ColliderComponent &collider, const Placement &p) {
+  for (int y = p.y0; y <= p.y1; y++) {
+    for (int x = p.x0; x <= p.x1; x++) {
+      cells[static_cast<std::size_t>(y) * width + x].push_back(
+          {&collider, p.order});
+    }
+  }
+}
+
+void ColliderGrid::unlink(const ColliderComponent *collider,
+                          const Placement &p) {
+  for (int y = p.y0; y <= p.y1; y++) {
+    for (int x = p.x0; x <= p.x1; x++) {
+      auto &cell = cells[static_cast<std::size_t>(y) * width + x];
+      cell.erase(std::remove_if(cell.begin(), cell.end(),
+                                [collider](const Entry &entry) {
+                                  return entry.collider == collider;
+                                }),
+                 cell.end());
+    }
+  }
+}
+
+void ColliderGrid::insert(ColliderComponent &collider, std::uint32_t order) {
+  Placement p = cover(collider.collider);
+  p.order = order;
+  link(collider, p);
+  placed[&collider] = p;
+}
+
+void ColliderGrid::remove(const ColliderComponent *collider) {
+  auto it = placed.find(collider);
+  if (it == placed.end()) {
+    return;
+  }
+  unlink(collider, it->second);
+  placed.erase(it);
+}
+
+/**
+ * Re-bin a collider whose rectangle may have changed; nothing happens while
+ * it stays over the same cells
+ */
+void ColliderGrid::move(ColliderComponent &collider) {
+  auto it = placed.find(&collider);
+  if (it == placed.end()) {
+    return;
+  }
+
+  Placement now = cover(collider.collider);
+  Placement &was = it->second;
+  if (now.x0 == was.x0 && now.y0 == was.y0 && now.x1 == was.x1 &&
+      now.y1 == was.y1) {
+    return;
+  }
+
+  // The placement is updated in place: no map node is freed and reallocated
+  now.order = was.order;
+  unlink(&collider, was);
+  link(collider, now);
+  was = now;
+}
+
+void ColliderGrid::rebuild(Manager &manager) {
+  for (auto &cell : cells) {
+    cell.clear();
+  }
+  placed.clear();
+  nextOrder = 0;
+
+  for (ColliderComponent *collider :
+       manager.getComponents<ColliderComponent>()) {
+    if (!collider->entity->isActive()) {
+      continue;
+    }
+    if (!collider->isStatic) {
+      collider->sync();
+    }
+    insert(*collider, nextOrder++);
+  }
+}
+
+void ColliderGrid::Update(Manager &manager) {
+  if (cells.empty()) {
+    return;
+  }
+
+  const std::uint64_t since = mark;
+
+  if (manager.rebuiltSince(since)) {
+    rebuild(manager);
+  } else {
+    // Removals first: a new collider may reuse the address of a deleted one
+    manager.forEachRemoved<ColliderComponent>(
+        since, [this](const ColliderComponent *collider) { remove(collider); });
+    manager.forEachAdded<ColliderComponent>(
+        since, [this](ColliderComponent &collider) {
+          if (collider.entity->isActive() &&
+              placed.find(&collider) == placed.end()) {
+            insert(collider, nextOrder++);
+          }
+        });
+
+    // Colliders follow the transforms that moved
+    manager.forEachChanged<TransformComponent>(
+        since, [&manager](TransformComponent &transform) {
+          Entity &e = *transform.entity;
+          if (e.hasComponent<ColliderComponent>()) {
+            auto &collider = e.getComponent<ColliderComponent>();
+            if (!collider.isStatic) {
+              collider.sync();
+              manager.markChanged(collider);
+            }
+          }
+        });
+    manager.forEachChanged<ColliderComponent>(
+        since, [this](ColliderComponent &collider) { move(collider); });
+  }
+
+  // Taken last: the colliders synced above are not visited again
+  mark = manager.changeMark();
+}
+
+void ColliderGrid::Query(const SDL_Rect &rect,
+                         std::vector<ColliderComponent *> &out) {
+  found.clear();
+  const Placement p = cover(rect);
+  for (int y = p.y0; y <= p.y1; y++) {
+    for (int x = p.x0; x <= p.x1; x++) {
+      const auto &cell = cells[static_cast<std::size_t>(y) * width + x];
+      found.insert(found.end(), cell.begin(), cell.end());
+    }
+  }
+
+  // A collider over several cells is found once per cell
+  std::sort(found.begin(), found.end(), [](const Entry &a, const Entry &b) {
+    return a.order < b.order;
+  });
+  found.erase(std::unique(found.begin(), found.end(),
+                          [](const Entry &a, const Entry &b) {
+                            return a.order == b.order;
+                          }),
+              found.end());
+
+  out.clear();
+  for (const Entry &entry : found) {
+    out.push_back(entry.collider);
+  }
+}
@@ -0,0 +1,66 @@
+#ifndef COLLIDER_GRID_HPP
+#define COLLIDER_GRID_HPP
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class ColliderComponent;
+class Manager;
+
+/**
+ * ColliderGrid class
+ *
+ * Broadphase for collision tests: every collider is listed in the grid
+ * cells its rectangle overlaps, so a query only visits the colliders around
+ * a rectangle. Colliders outside the grid are kept in its border cells.
+ *
+ * Update() works from the manager's change detection. Colliders follow the
+ * transforms that changed since the previous update, and only colliders
+ * that were added, moved or removed are re-binned; a world that stands
+ * still costs nothing. After a snapshot load the grid is rebuilt.
+ *
+ * @author: @iMeyu
+ */
+class ColliderGrid {
+public:
+  void SetGrid(int width, int height, int cellSize); // In cells; empties it
+
+  void Update(Manager &manager);
+
+  // Colliders listed in the cells rect overlaps, each once, in the order
+  // they entered the grid. out is cleared first.
+  void Query(const SDL_Rect &rect, std::vector<ColliderComponent *> &out);
+
+private:
+  struct Entry {
+    ColliderComponent *collider;
+    std::uint32_t order; // Keeps query results in a stable order
+  };
+
+  struct Placement {
+    int x0, y0, x1, y1; // Cells covered, inclusive
+    std::uint32_t order;
+  };
+
+  Placement cover(const SDL_Rect &rect) const;
+  void link(ColliderComponent &collider, const Placement &p);
+  void unlink(const ColliderComponent *collider, const Placement &p);
+  void insert(ColliderComponent &collider, std::uint32_t order);
+  void remove(const ColliderComponent *collider);
+  void move(ColliderComponent &collider);
+  void rebuild(Manager &manager);
+
+  std::vector<std::vector<Entry>> cells; // Row major
+  std::unordered_map<const ColliderComponent *, Placement> placed;
+  std::vector<Entry> found; // Query scratch
+
+  int width = 0;
+  int height = 0;
+  int cellSize = 1;
+  std::uint32_t nextOrder = 0;
+  std::uint64_t mark = 0; // Change clock of the last update
+};
+
+#endif
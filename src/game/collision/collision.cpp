@@ -1,14 +1,61 @@
 #include "collision.hpp"
+#include "../../utility/logger/logger.hpp"
 #include "../components/colliderComponent/collider_component.hpp"
 
+std::array<CollisionMask, maxCollisionLayers> Collision::masks = {};
+std::vector<std::string> Collision::layerNames;
+
 bool Collision::AABB(const SDL_Rect &rectA, const SDL_Rect &rectB) {
   return SDL_HasIntersection(&rectA, &rectB);
 }
 
+/**
+ * Whether two colliders touch and their layers collide.
+ * The layer test comes first: it is a single AND.
+ */
 bool Collision::AABB(const ColliderComponent &colA,
                      const ColliderComponent &colB) {
-  if (SDL_HasIntersection(&colA.collider, &colB.collider) && colA.tag != colB.tag) {
-    return true;
+  return Collides(colA.layer, colB.layer) &&
+         SDL_HasIntersection(&colA.collider, &colB.collider);
+}
+
+/**
+ * Get the layer of a tag, creating it on first use.
+ * Meant for load time: colliders keep the layer, not the tag.
+ */
+CollisionLayer Collision::Layer(const std::string &tag) {
+  for (std::size_t i = 0; i < layerNames.size(); i++) {
+    if (layerNames[i] == tag) {
+      return static_cast<CollisionLayer>(i);
+    }
+  }
+
+  if (layerNames.size() == maxCollisionLayers) {
+    LOG_ERROR("Too many collision layers, \"%s\" shares the last one",
+              tag.c_str());
+    return static_cast<CollisionLayer>(maxCollisionLayers - 1);
+  }
+
+  const auto layer = static_cast<CollisionLayer>(layerNames.size());
+  layerNames.push_back(tag);
+
+  // Collide with every existing layer, as different tags always did
+  for (CollisionLayer other = 0; other < layer; other++) {
+    SetCollides(layer, other, true);
+  }
+  return layer;
+}
+
+/**
+ * Set whether two layers collide, in both directions
+ */
+void Collision::SetCollides(CollisionLayer a, CollisionLayer b,
+                            bool collides) {
+  if (collides) {
+    masks[a] |= CollisionMask{1} << b;
+    masks[b] |= CollisionMask{1} << a;
+  } else {
+    masks[a] &= ~(CollisionMask{1} << b);
+    masks[b] &= ~(CollisionMask{1} << a);
   }
-  return false;
-}
\ No newline at end of file
+}
@@ -2,14 +2,44 @@
 #define COLLISION_HPP
 
 #include <SDL2/SDL.h>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
 
 class ColliderComponent;
 
+// Index of a collision layer, and a set of layers as one bit per layer
+using CollisionLayer = std::uint8_t;
+using CollisionMask = std::uint32_t;
+
+constexpr std::size_t maxCollisionLayers = 32;
+
+/**
+ * Collision class
+ *
+ * Colliders belong to one layer. Which layers collide is kept in a matrix,
+ * one mask per layer, so every pair test is a single AND. Layers are named
+ * by the tags used when authoring colliders; a new tag gets a new layer that
+ * collides with every other layer but not with itself.
+ */
 class Collision {
 public:
   static bool AABB(const SDL_Rect &rectA, const SDL_Rect &rectB);
   static bool AABB(const ColliderComponent &colA,
                    const ColliderComponent &colB);
+
+  static CollisionLayer Layer(const std::string &tag); // Resolve a tag
+  static void SetCollides(CollisionLayer a, CollisionLayer b, bool collides);
+
+  static CollisionMask Mask(CollisionLayer layer) { return masks[layer]; }
+  static bool Collides(CollisionLayer a, CollisionLayer b) {
+    return (masks[a] & (CollisionMask{1} << b)) != 0;
+  }
+
+private:
+  static std::array<CollisionMask, maxCollisionLayers> masks;
+  static std::vector<std::string> layerNames;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,75 @@
+#include "behaviour_component.hpp"
+#include "../../../utility/logger/logger.hpp"
+#include "../../snapshot/snapshot.hpp"
+#include <cstring>
+#include <vector>
+
+namespace {
+
+struct RegisteredScript {
+  const char *name;
+  BehaviourComponent::Script script;
+};
+
+std::vector<RegisteredScript> &scripts() {
+  static std::vector<RegisteredScript> registered;
+  return registered;
+}
+
+} // namespace
+
+void BehaviourComponent::RegisterScript(const char *name, Script script) {
+  if (ScriptIndex(name) != -1) {
+    LOG_WARNING("Behaviour script registered twice: %s", name);
+    return;
+  }
+  scripts().push_back({name, script});
+}
+
+int BehaviourComponent::ScriptIndex(const char *name) {
+  const auto &registered = scripts();
+  for (std::size_t i = 0; i < registered.size(); i++) {
+    if (std::strcmp(registered[i].name, name) == 0) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+BehaviourComponent::~BehaviourComponent() {
+  BehaviourScheduler::Stop(running);
+}
+
+void BehaviourComponent::init() {
+  if (script == -1) {
+    LOG_WARNING("Behaviour component without a registered script");
+    return;
+  }
+  restart();
+}
+
+void BehaviourComponent::restart() {
+  BehaviourScheduler::Stop(running);
+  running = {};
+  if (script >= 0 && static_cast<std::size_t>(script) < scripts().size()) {
+    running =
+        BehaviourScheduler::Start(*entity, scripts()[script].script(*entity));
+  }
+}
+
+void BehaviourComponent::save(SnapshotWriter &out) const {
+  out.write(script);
+  out.write(progress.started);
+  out.write(progress.stage);
+  out.write(progress.untilTick);
+  out.write(progress.anchor);
+}
+
+void BehaviourComponent::load(SnapshotReader &in) {
+  in.read(script);
+  in.read(progress.started);
+  in.read(progress.stage);
+  in.read(progress.untilTick);
+  in.read(progress.anchor);
+  restart();
+}
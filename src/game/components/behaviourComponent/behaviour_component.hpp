@@ -0,0 +1,54 @@
+#ifndef BEHAVIOUR_COMPONENT_HPP
+#define BEHAVIOUR_COMPONENT_HPP
+
+#include "../../ECS/ECS.hpp"
+#include "../../behaviour/behaviour.hpp"
+
+/**
+ * BehaviourComponent class
+ *
+ * Runs a registered behaviour script for the entity while the component
+ * exists. Scripts are registered once by name, so a component refers to one
+ * by index and can be saved.
+ *
+ * A coroutine frame cannot be written out, so a loaded component starts its
+ * script over. Snapshots store the script and its progress, from which the
+ * script resumes where it was.
+ *
+ * @author: @iMeyu
+ */
+class BehaviourComponent : public Component {
+public:
+  using Script = Behaviour (*)(Entity &self);
+
+  static void RegisterScript(const char *name, Script script);
+  static int ScriptIndex(const char *name); // -1 if not registered
+
+  BehaviourComponent() = default; // For snapshots, which load the state
+  explicit BehaviourComponent(const char *script)
+      : script(ScriptIndex(script)) {}
+  ~BehaviourComponent();
+
+  void init();
+
+  void save(SnapshotWriter &out) const;
+  void load(SnapshotReader &in);
+
+  // Kept by the script for resuming it; each script gives the fields its
+  // own meaning
+  struct Progress {
+    bool started = false;
+    std::int32_t stage = 0;
+    std::uint64_t untilTick = 0; // Manager tick a wait ends at, 0 if none
+    Vector2D anchor;
+  };
+  Progress progress;
+
+private:
+  void restart();
+
+  int script = -1;
+  BehaviourId running;
+};
+
+#endif
@@ -1,11 +1,12 @@
 #include "./collider_component.hpp"
-#include "../../../textureManager/texture_manager.hpp"
+#include "../../debugDraw/debug_draw.hpp"
+#include "../../snapshot/snapshot.hpp"
 
-ColliderComponent::ColliderComponent(std::string tag) { this->tag = tag; }
+ColliderComponent::ColliderComponent(std::string tag) { layer = Collision::Layer(tag); }
 
 ColliderComponent::ColliderComponent(std::string tag, int xPos, int yPos,
                                      int size) {
-  this->tag = tag;
+  layer = Collision::Layer(tag);
   collider.x = xPos;
   collider.y = yPos;
   collider.w = size;
@@ -14,7 +15,7 @@ ColliderComponent::ColliderComponent(std::string tag, int xPos, int yPos,
 
 ColliderComponent::ColliderComponent(std::string tag, int xPos, int yPos,
                                      int width, int height) {
-  this->tag = tag;
+  layer = Collision::Layer(tag);
   collider.x = xPos;
   collider.y = yPos;
   collider.w = width;
@@ -24,7 +25,7 @@ ColliderComponent::ColliderComponent(std::string tag, int xPos, int yPos,
 ColliderComponent::ColliderComponent(std::string tag, int xPos, int yPos,
                                      int width, int height, int offsetX,
                                      int offsetY) {
-  this->tag = tag;
+  layer = Collision::Layer(tag);
   collider.x = xPos;
   collider.y = yPos;
   collider.w = width;
@@ -34,39 +35,52 @@ ColliderComponent::ColliderComponent(std::string tag, int xPos, int yPos,
 }
 
 void ColliderComponent::init() {
+  // Colliders without a transform never move
   if (!entity->hasComponent<TransformComponent>()) {
-    entity->addComponent<TransformComponent>();
+    isStatic = true;
+    return;
   }
 
   transform = &entity->getComponent<TransformComponent>();
+}
 
-  texture = TextureManager::LoadTexture("assets/col-sprite.png");
-  srcRect = {0, 0, 32, 32};
-  destRect = {collider.x, collider.y, collider.w, collider.h};
-
-  // Game::colliders.push_back(this);
+void ColliderComponent::sync() {
+  collider.x = static_cast<int>(transform->position.x) + offsetX;
+  collider.y = static_cast<int>(transform->position.y) + offsetY;
 }
 
-void ColliderComponent::update() {
-  if (tag != "terrain") {
-    collider.x = static_cast<int>(transform->position.x) + offsetX;
-    collider.y = static_cast<int>(transform->position.y) + offsetY;
+/**
+ * Outline the collider on the debug overlay (F1)
+ */
+void ColliderComponent::draw() {
+  if (!Game::showColliders) {
+    return;
   }
 
-  destRect.x = collider.x - Game::camera.x;
-  destRect.y = collider.y - Game::camera.y;
+  const SDL_Color color =
+      isStatic ? SDL_Color{255, 64, 64, 255} : SDL_Color{64, 255, 64, 255};
+  DebugDraw::Rect(collider, color);
 }
 
-void ColliderComponent::draw() {
-  if (texture) {
-    TextureManager::Draw(texture, srcRect, destRect, SDL_FLIP_NONE);
-  }
+void ColliderComponent::save(SnapshotWriter &out) const {
+  out.write(collider);
+  out.write(layer);
+  out.write(isStatic);
+  out.write(offsetX);
+  out.write(offsetY);
+}
+
+void ColliderComponent::load(SnapshotReader &in) {
+  transform = entity->hasComponent<TransformComponent>()
+                  ? &entity->getComponent<TransformComponent>()
+                  : nullptr;
+
+  in.read(collider);
+  in.read(layer);
+  in.read(isStatic);
+  in.read(offsetX);
+  in.read(offsetY);
 }
 
 // Provide out-of-line virtual destructor to ensure vtable emission
-ColliderComponent::~ColliderComponent() {
-  if (texture) {
-    SDL_DestroyTexture(texture);
-    texture = nullptr;
-  }
-}
\ No newline at end of file
+ColliderComponent::~ColliderComponent() {}
\ No newline at end of file
@@ -2,25 +2,33 @@
 #define COLLIDER_COMPONENT_HPP
 
 #include "../../ECS/ECS.hpp"
+#include "../../collision/collision.hpp"
 #include "../../game.hpp"
 #include "../transformComponent/transform_component.hpp"
 #include <SDL2/SDL.h>
 #include <string>
 
+/**
+ * ColliderComponent class
+ *
+ * The tag given to the constructor is resolved to a collision layer once.
+ * A collider whose entity has no TransformComponent is static: it keeps the
+ * rectangle it was created with and is never synced. The others are synced
+ * by ColliderGrid when their transform changes.
+ */
 class ColliderComponent : public Component {
 public:
   SDL_Rect collider;
-  std::string tag;
+  CollisionLayer layer = 0;
+  bool isStatic = false;
 
-  SDL_Texture *texture;
-  SDL_Rect srcRect, destRect;
-
-  TransformComponent *transform;
+  TransformComponent *transform = nullptr;
 
   // Optional local offset from the entity transform position
   int offsetX = 0;
   int offsetY = 0;
 
+  ColliderComponent() = default; // For snapshots, which load the state
   ColliderComponent(std::string tag);
   ColliderComponent(std::string tag, int xPos, int yPos, int size);
   ColliderComponent(std::string tag, int xPos, int yPos, int width, int height);
@@ -29,9 +37,13 @@ public:
 
   ~ColliderComponent() override; // Out-of-line destructor declaration
 
-  void init() override;
-  void update() override;
-  void draw() override;
+  void init();
+  void draw();
+
+  void sync(); // Follow the transform
+
+  void save(SnapshotWriter &out) const;
+  void load(SnapshotReader &in);
 };
 
 #endif
\ No newline at end of file
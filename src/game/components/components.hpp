@@ -8,4 +8,7 @@
 #include "./tileComponent/tile_component.hpp"
 #include "./transformComponent/transform_component.hpp"
 #include "./followDelayComponent/follow_delay_component.hpp"
+#include "./particleEmitterComponent/particle_emitter_component.hpp"
+#include "./navigationComponent/navigation_component.hpp"
+#include "./behaviourComponent/behaviour_component.hpp"
 #endif
\ No newline at end of file
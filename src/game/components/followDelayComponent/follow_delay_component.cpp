@@ -1,41 +1,97 @@
 #include "follow_delay_component.hpp"
+#include "../../snapshot/snapshot.hpp"
 
 void FollowDelayComponent::init() {
     followerTransform = &entity->getComponent<TransformComponent>();
-    if (entity->hasComponent<SpriteComponent>()) {
-      followerSprite = &entity->getComponent<SpriteComponent>();
+    if (leaderEntity) {
+      leaderTransform = &leaderEntity->getComponent<TransformComponent>();
     }
-    leaderTransform = &leaderEntity->getComponent<TransformComponent>();
     if (delayFrames < 0) {
       delayFrames = 0;
     }
+    positionHistory.resize(static_cast<std::size_t>(delayFrames) + 1);
+    historyStart = 0;
+    historyCount = 0;
 }
 
 void FollowDelayComponent::update() {
-    // Lazily bind sprite if added after this component
-    if (followerSprite == nullptr && entity->hasComponent<SpriteComponent>()) {
-      followerSprite = &entity->getComponent<SpriteComponent>();
+    if (!leaderTransform) {
+      return;
     }
 
-    // Record leader position each frame
-    positionHistory.emplace_back(leaderTransform->position);
+    // Record leader position each frame; a reduced-rate update records it
+    // once per tick it stands for, so the delay stays the same in time
+    const std::size_t capacity = positionHistory.size();
+    const std::uint32_t ticks = entity->ticksPerUpdate();
+    bool delayed = false;
+    Vector2D delayedPosition;
+    for (std::uint32_t t = 0; t < ticks; t++) {
+      positionHistory[(historyStart + historyCount) % capacity] =
+          leaderTransform->position;
+      historyCount++;
 
-    if (static_cast<int>(positionHistory.size()) > (delayFrames)) {
+      if (static_cast<int>(historyCount) > (delayFrames)) {
+        delayedPosition = positionHistory[historyStart];
+        historyStart = (historyStart + 1) % capacity;
+        historyCount--;
+        delayed = true;
+      }
+    }
+
+    if (delayed) {
       const Vector2D previousPosition = followerTransform->position;
-      const Vector2D delayedPosition = positionHistory.front();
-      positionHistory.pop_front();
 
       // Move follower to delayed leader position plus the initial offset
       const float nextX = delayedPosition.x;
       const float nextY = delayedPosition.y; 
       followerTransform->position.x = nextX;
       followerTransform->position.y = nextY;
+      entity->markChanged<TransformComponent>();
 
-      // Optional: update animation based on movement
-      if (followerSprite != nullptr) {
-        const bool moved = (previousPosition.x != nextX) ||
-                           (previousPosition.y != nextY);
-        followerSprite->play(moved ? "walk" : "idle");
+      // Animations react to the event, only when the state changes
+      const bool moved = (previousPosition.x != nextX) ||
+                         (previousPosition.y != nextY);
+      if (moved != moving) {
+        moving = moved;
+        EventBus::Emit(MovementChangedEvent{entity, moving});
       }
     }
-}
\ No newline at end of file
+}
+
+void FollowDelayComponent::save(SnapshotWriter &out) const {
+    out.writeEntity(leaderEntity);
+    out.write(delayFrames);
+    out.write(moving);
+
+    out.write(static_cast<std::uint32_t>(historyCount));
+    for (std::size_t i = 0; i < historyCount; i++) {
+      out.write(
+          positionHistory[(historyStart + i) % positionHistory.size()]);
+    }
+}
+
+void FollowDelayComponent::load(SnapshotReader &in) {
+    leaderEntity = in.readEntity();
+    followerTransform = &entity->getComponent<TransformComponent>();
+    leaderTransform = leaderEntity
+                          ? &leaderEntity->getComponent<TransformComponent>()
+                          : nullptr;
+    in.read(delayFrames);
+    in.read(moving);
+    if (delayFrames < 0) {
+      delayFrames = 0;
+    }
+    positionHistory.resize(static_cast<std::size_t>(delayFrames) + 1);
+    historyStart = 0;
+    historyCount = 0;
+
+    std::uint32_t count = 0;
+    in.read(count);
+    Vector2D position;
+    for (std::uint32_t i = 0; i < count && in.read(position); i++) {
+      // A saved history is never longer than delayFrames + 1
+      if (historyCount < positionHistory.size()) {
+        positionHistory[historyCount++] = position;
+      }
+    }
+}
@@ -1,8 +1,9 @@
 #ifndef FOLLOW_DELAY_COMPONENT_HPP
 #define FOLLOW_DELAY_COMPONENT_HPP
 
-#include <deque>
 #include <cmath>
+#include <cstddef>
+#include <vector>
 
 #include "../../ECS/ECS.hpp"
 #include "../transformComponent/transform_component.hpp"
@@ -10,20 +11,28 @@
 
 class FollowDelayComponent : public Component {
 public:
+  FollowDelayComponent() = default; // For snapshots, which load the state
   explicit FollowDelayComponent(Entity *leaderEntity, int delayFrames)
       : leaderEntity(leaderEntity), delayFrames(delayFrames) {}
 
-  void init() override;
-  void update() override;
+  void init();
+  void update();
+
+  void save(SnapshotWriter &out) const;
+  void load(SnapshotReader &in);
 
 private:
   Entity *leaderEntity = nullptr;
   TransformComponent *leaderTransform = nullptr;
   TransformComponent *followerTransform = nullptr;
-  SpriteComponent *followerSprite = nullptr;
 
   int delayFrames = 0;
-  std::deque<Vector2D> positionHistory;
+  bool moving = false; // Reported through MovementChangedEvent on change
+
+  // Ring of the leader's last positions, sized delayFrames + 1 once
+  std::vector<Vector2D> positionHistory;
+  std::size_t historyStart = 0; // Oldest position
+  std::size_t historyCount = 0;
 };
 
 #endif
@@ -1,5 +1,6 @@
 // Ensure implementation of the class method declared in the header
 #include "keyboard_controller.hpp"
+#include "../../snapshot/snapshot.hpp"
 
 void KeyboardController::init() {
   transform = &entity->getComponent<TransformComponent>();
@@ -8,19 +9,33 @@ void KeyboardController::init() {
 }
 
 void KeyboardController::update() {
-  const Uint8 *state = SDL_GetKeyboardState(nullptr);
+  // Sampled once per tick by Game::handleEvents, never read from SDL here
+  const InputSnapshot &input = Input::Current();
 
-  int dirX = (state[SDL_SCANCODE_RIGHT] || state[SDL_SCANCODE_D]) -
-             (state[SDL_SCANCODE_LEFT] || state[SDL_SCANCODE_A]);
-  int dirY = (state[SDL_SCANCODE_DOWN] || state[SDL_SCANCODE_S]) -
-             (state[SDL_SCANCODE_UP] || state[SDL_SCANCODE_W]);
+  const float dirX = input.axis(Axis::MoveX);
+  const float dirY = input.axis(Axis::MoveY);
 
-  transform->velocity.x = dirX * transform->speed;
-  transform->velocity.y = dirY * transform->speed;
+  const float velocityX = dirX * transform->speed;
+  const float velocityY = dirY * transform->speed;
+  if (velocityX != transform->velocity.x ||
+      velocityY != transform->velocity.y) {
+    transform->velocity.x = velocityX;
+    transform->velocity.y = velocityY;
+    entity->markChanged<TransformComponent>();
+  }
 
-  if (dirX != 0 || dirY != 0) {
-    sprite->play("walk");
-  } else {
-    sprite->play("idle");
+  // Animations react to the event, only when the state changes
+  const bool nowMoving = dirX != 0.0f || dirY != 0.0f;
+  if (nowMoving != moving) {
+    moving = nowMoving;
+    EventBus::Emit(MovementChangedEvent{entity, moving});
   }
-}
\ No newline at end of file
+}
+
+void KeyboardController::save(SnapshotWriter &out) const { out.write(moving); }
+
+void KeyboardController::load(SnapshotReader &in) {
+  transform = &entity->getComponent<TransformComponent>();
+  sprite = &entity->getComponent<SpriteComponent>();
+  in.read(moving);
+}
@@ -3,6 +3,7 @@
 
 #include "../../../game/game.hpp"
 #include "../../ECS/ECS.hpp"
+#include "../../input/input.hpp"
 #include "../spriteComponent/sprite_component.hpp"
 #include "../transformComponent/transform_component.hpp"
 #include <cmath>
@@ -13,14 +14,14 @@ public:
   TransformComponent *transform;
   SpriteComponent *sprite;
 
-  void init() override;
-  void update() override;
+  void init();
+  void update();
 
-private: 
-  bool upPressed = false;
-  bool downPressed = false;
-  bool leftPressed = false;
-  bool rightPressed = false;
+  void save(SnapshotWriter &out) const;
+  void load(SnapshotReader &in);
+
+private:
+  bool moving = false; // Reported through MovementChangedEvent on change
 };
 
 #endif
\ No newline at end of file
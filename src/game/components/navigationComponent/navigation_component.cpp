@@ -0,0 +1,44 @@
+#include "navigation_component.hpp"
+#include "../../snapshot/snapshot.hpp"
+
+void NavigationComponent::init() {
+  transform = &entity->getComponent<TransformComponent>();
+  transform->speed = speed;
+}
+
+void NavigationComponent::update() {
+  if (!field) {
+    transform->velocity.Zero();
+    return;
+  }
+
+  const float centerX =
+      transform->position.x + transform->width * transform->scale * 0.5f;
+  const float centerY =
+      transform->position.y + transform->height * transform->scale * 0.5f;
+
+  const Vector2D velocity = field->Direction(centerX, centerY);
+  if (velocity.x != transform->velocity.x ||
+      velocity.y != transform->velocity.y) {
+    transform->velocity = velocity;
+    entity->markChanged<TransformComponent>();
+  }
+
+  const bool nowMoving =
+      transform->velocity.x != 0.0f || transform->velocity.y != 0.0f;
+  if (nowMoving != moving) {
+    moving = nowMoving;
+    EventBus::Emit(MovementChangedEvent{entity, moving});
+  }
+}
+
+void NavigationComponent::save(SnapshotWriter &out) const {
+  out.write(speed);
+  out.write(moving);
+}
+
+void NavigationComponent::load(SnapshotReader &in) {
+  transform = &entity->getComponent<TransformComponent>();
+  in.read(speed);
+  in.read(moving);
+}
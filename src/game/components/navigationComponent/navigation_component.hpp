@@ -0,0 +1,37 @@
+#ifndef NAVIGATION_COMPONENT_HPP
+#define NAVIGATION_COMPONENT_HPP
+
+#include "../../ECS/ECS.hpp"
+#include "../../flowField/flow_field.hpp"
+#include "../transformComponent/transform_component.hpp"
+
+/**
+ * NavigationComponent class
+ *
+ * Steers the entity along a shared FlowField: each tick its velocity becomes
+ * the field's direction at the centre of its transform. Any number of
+ * entities can follow the same field.
+ *
+ * Snapshots do not store the field: a restored component keeps the field it
+ * had, and one created by a restore stands still.
+ */
+class NavigationComponent : public Component {
+public:
+  NavigationComponent() = default; // For snapshots, which load the state
+  explicit NavigationComponent(const FlowField *field, int speed = 1)
+      : field(field), speed(speed) {}
+
+  void init();
+  void update();
+
+  void save(SnapshotWriter &out) const;
+  void load(SnapshotReader &in);
+
+private:
+  const FlowField *field = nullptr;
+  TransformComponent *transform = nullptr;
+  int speed = 1;
+  bool moving = false; // Reported through MovementChangedEvent on change
+};
+
+#endif
@@ -0,0 +1,95 @@
+#include "particle_emitter_component.hpp"
+#include "../../snapshot/snapshot.hpp"
+#include <cmath>
+
+ParticleEmitterComponent::ParticleEmitterComponent(const char *texturePath) {
+  pool = ParticleSystem::Pool(TextureManager::LoadTextureAsync(texturePath));
+}
+
+ParticleEmitterComponent::ParticleEmitterComponent(const char *texturePath,
+                                                   float rate, float lifetime)
+    : ParticleEmitterComponent(texturePath) {
+  this->rate = rate;
+  this->lifetime = lifetime;
+}
+
+void ParticleEmitterComponent::init() {
+  transform = &entity->getComponent<TransformComponent>();
+}
+
+void ParticleEmitterComponent::setGravity(float pixelsPerSecond2) {
+  ParticleSystem::SetGravity(pool, pixelsPerSecond2);
+}
+
+void ParticleEmitterComponent::update() {
+  if (!active) {
+    pending = 0.0f;
+    return;
+  }
+
+  pending += rate * particleTickSeconds *
+             static_cast<float>(entity->ticksPerUpdate());
+
+  const float originX = transform->position.x + offsetX;
+  const float originY = transform->position.y + offsetY;
+
+  for (; pending >= 1.0f; pending -= 1.0f) {
+    const float angle = direction + (random() - 0.5f) * spread;
+    const float particleSpeed = speed * (0.5f + random());
+
+    ParticleSpawn spawn;
+    spawn.x = originX;
+    spawn.y = originY;
+    spawn.vx = std::cos(angle) * particleSpeed;
+    spawn.vy = std::sin(angle) * particleSpeed;
+    spawn.lifetime = lifetime * (0.75f + 0.5f * random());
+    spawn.size = size;
+    spawn.startColor = startColor;
+    spawn.endColor = endColor;
+    ParticleSystem::Spawn(pool, spawn);
+  }
+}
+
+void ParticleEmitterComponent::save(SnapshotWriter &out) const {
+  out.write(active);
+  out.write(rate);
+  out.write(lifetime);
+  out.write(speed);
+  out.write(spread);
+  out.write(direction);
+  out.write(size);
+  out.write(offsetX);
+  out.write(offsetY);
+  out.write(startColor);
+  out.write(endColor);
+  out.write(pool);
+  out.write(pending);
+  out.write(seed);
+}
+
+void ParticleEmitterComponent::load(SnapshotReader &in) {
+  transform = &entity->getComponent<TransformComponent>();
+
+  in.read(active);
+  in.read(rate);
+  in.read(lifetime);
+  in.read(speed);
+  in.read(spread);
+  in.read(direction);
+  in.read(size);
+  in.read(offsetX);
+  in.read(offsetY);
+  in.read(startColor);
+  in.read(endColor);
+  in.read(pool);
+  in.read(pending);
+  in.read(seed);
+}
+
+// xorshift32
+float ParticleEmitterComponent::random() {
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  return static_cast<float>(seed >> 8) * (1.0f / 16777216.0f);
+}
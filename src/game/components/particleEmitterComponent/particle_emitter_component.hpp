@@ -0,0 +1,50 @@
+#ifndef PARTICLE_EMITTER_COMPONENT_HPP
+#define PARTICLE_EMITTER_COMPONENT_HPP
+
+#include "../../ECS/ECS.hpp"
+#include "../../particleSystem/particle_system.hpp"
+#include "../transformComponent/transform_component.hpp"
+#include <cstdint>
+
+/**
+ * ParticleEmitterComponent class
+ *
+ * Spawns particles into the ParticleSystem pool of its texture, around the
+ * entity's transform. The particles themselves are not entities.
+ */
+class ParticleEmitterComponent : public Component {
+public:
+  bool active = true;
+  float rate = 60.0f;      // Particles per second
+  float lifetime = 0.5f;   // Seconds
+  float speed = 40.0f;     // Pixels per second
+  float spread = 6.2832f;  // Radians around direction, full circle by default
+  float direction = 0.0f;  // Radians, 0 points right
+  float size = 4.0f;       // Pixels
+  float offsetX = 0.0f;    // From the transform position
+  float offsetY = 0.0f;
+  SDL_Color startColor = {255, 255, 255, 255};
+  SDL_Color endColor = {255, 255, 255, 0};
+
+  ParticleEmitterComponent() = default; // For snapshots, which load the state
+  ParticleEmitterComponent(const char *texturePath);
+  ParticleEmitterComponent(const char *texturePath, float rate, float lifetime);
+
+  void init();
+  void update();
+
+  void save(SnapshotWriter &out) const;
+  void load(SnapshotReader &in);
+
+  void setGravity(float pixelsPerSecond2);
+
+private:
+  TransformComponent *transform = nullptr;
+  std::size_t pool = 0;
+  float pending = 0.0f;      // Fraction of a particle carried to next tick
+  std::uint32_t seed = 1;    // Deterministic, so replays spawn alike
+
+  float random(); // Uniform in [0, 1)
+};
+
+#endif
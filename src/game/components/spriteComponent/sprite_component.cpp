@@ -1,10 +1,11 @@
 #include "sprite_component.hpp"
+#include "../../snapshot/snapshot.hpp"
+#include <vector>
 
-SpriteComponent::SpriteComponent(const char *path) { setTexture(path); }
+namespace {
 
-SpriteComponent::SpriteComponent(const char *path, bool isAnimated) {
-  setTexture(path);
-  animated = isAnimated;
+// The animations of the sprite sheets, shared by every animated sprite
+AnimationTable sheetAnimations() {
   int idleIndex = 0;
   int idleUpIndex = 10;
   int idleRightIndex = 2;
@@ -14,67 +15,144 @@ SpriteComponent::SpriteComponent(const char *path, bool isAnimated) {
   int framesNumber = 10;
   int reproductionSpeed = 100;
 
-  Animation idle = Animation(idleIndex, framesNumber, reproductionSpeed);
-  Animation idleUp = Animation(idleUpIndex, framesNumber, reproductionSpeed);
-  Animation idleRight =
-      Animation(idleRightIndex, framesNumber, reproductionSpeed);
-  Animation idleLeft =
-      Animation(idleLeftIndex, framesNumber, reproductionSpeed);
-  Animation walk = Animation(walkIndex, framesNumber, reproductionSpeed);
-
-  animations.emplace("idle", idle);
-  animations.emplace("idleUp", idleUp);
-  animations.emplace("idleRight", idleRight);
-  animations.emplace("idleLeft", idleLeft);
-  animations.emplace("walk", walk);
+  AnimationTable animations;
+  animations.emplace("idle",
+                     Animation(idleIndex, framesNumber, reproductionSpeed));
+  animations.emplace("idleUp",
+                     Animation(idleUpIndex, framesNumber, reproductionSpeed));
+  animations.emplace("idleRight", Animation(idleRightIndex, framesNumber,
+                                            reproductionSpeed));
+  animations.emplace("idleLeft", Animation(idleLeftIndex, framesNumber,
+                                           reproductionSpeed));
+  animations.emplace("walk",
+                     Animation(walkIndex, framesNumber, reproductionSpeed));
+  return animations;
+}
 
-  play("idle");
+// Every animation table, built once and never modified; sprites refer to
+// one by its index
+const std::vector<AnimationTable> &animationTables() {
+  static const std::vector<AnimationTable> tables = {sheetAnimations()};
+  return tables;
 }
 
-SpriteComponent::~SpriteComponent() {
-  if (texture) {
-    SDL_DestroyTexture(texture);
-    texture = nullptr;
-  }
+constexpr int sheetTable = 0;
+
+} // namespace
+
+SpriteComponent::SpriteComponent(const char *path) { setTexture(path); }
+
+SpriteComponent::SpriteComponent(const char *path, bool isAnimated) {
+  setTexture(path);
+  animated = isAnimated;
+  animationTable = sheetTable;
+  play("idle");
 }
 
 void SpriteComponent::init() {
   transform = &entity->getComponent<TransformComponent>();
 
-  srcRect.x = srcRect.y = 0;
+  srcRect.x = 0;
+  srcRect.y = animationIndex * transform->height;
   srcRect.w = transform->width;
   srcRect.h = transform->height;
 }
 
 void SpriteComponent::update() {
   if (animated && frames > 0) {
-    srcRect.x = srcRect.w * static_cast<int>((SDL_GetTicks() / speed) % frames);
+    const int nextFrame = static_cast<int>((SDL_GetTicks() / speed) % frames);
+    if (nextFrame < frame) {
+      EventBus::Emit(AnimationFinishedEvent{entity, animationIndex});
+    }
+    frame = nextFrame;
+    srcRect.x = srcRect.w * frame;
   }
+}
 
-  srcRect.y = animationIndex * transform->height;
+void SpriteComponent::setTexture(const char *path) {
+  texture = TextureManager::LoadTextureAsync(path);
+}
 
+// The screen position is derived here rather than in update(), which
+// reduced-rate and sleeping entities skip
+void SpriteComponent::draw() {
   destRect.x = static_cast<int>(transform->position.x) - Game::camera.x;
   destRect.y = static_cast<int>(transform->position.y) - Game::camera.y;
   destRect.w = transform->width * transform->scale;
   destRect.h = transform->height * transform->scale;
-}
 
-void SpriteComponent::setTexture(const char *path) {
-  texture = TextureManager::LoadTexture(path);
-}
+  // Sorted by the world y of its feet: whoever stands lower is drawn over
+  const int feetY =
+      static_cast<int>(transform->position.y) + destRect.h + sortOffset;
 
-void SpriteComponent::draw() {
-  if (texture) {
-    TextureManager::Draw(texture, srcRect, destRect, spriteFlip);
+  if (texture != 0) {
+    Game::renderQueue.submit(texture, srcRect, destRect, spriteFlip, layer,
+                             feetY);
   }
 }
 
 void SpriteComponent::play(const char *animName) {
-  const std::string key(animName);
-  auto it = animations.find(key);
-  if (it != animations.end()) {
-    frames = it->second.frames;
-    animationIndex = it->second.index;
-    speed = it->second.speed;
+  if (animationTable < 0) {
+    return;
+  }
+  const AnimationTable &animations = animationTables()[animationTable];
+  auto it = animations.find(animName);
+  if (it == animations.end()) {
+    return;
+  }
+
+  const Animation &animation = it->second;
+  if (animation.index == animationIndex && animation.frames == frames &&
+      animation.speed == speed) {
+    return; // Already playing
+  }
+
+  frames = animation.frames;
+  animationIndex = animation.index;
+  speed = animation.speed;
+
+  // The row only changes here, not every update; play() also runs from the
+  // constructor, before there is an entity
+  if (transform) {
+    srcRect.y = animationIndex * transform->height;
+    entity->markChanged<SpriteComponent>();
   }
-}
\ No newline at end of file
+}
+
+void SpriteComponent::save(SnapshotWriter &out) const {
+  out.write(texture);
+  out.write(srcRect);
+  out.write(destRect);
+  out.write(animated);
+  out.write(frames);
+  out.write(speed);
+  out.write(frame);
+  out.write(animationIndex);
+  out.write(spriteFlip);
+  out.write(layer);
+  out.write(sortOffset);
+
+  out.write(animationTable);
+}
+
+void SpriteComponent::load(SnapshotReader &in) {
+  transform = &entity->getComponent<TransformComponent>();
+
+  in.read(texture);
+  in.read(srcRect);
+  in.read(destRect);
+  in.read(animated);
+  in.read(frames);
+  in.read(speed);
+  in.read(frame);
+  in.read(animationIndex);
+  in.read(spriteFlip);
+  in.read(layer);
+  in.read(sortOffset);
+
+  in.read(animationTable);
+  if (animationTable < 0 ||
+      animationTable >= static_cast<int>(animationTables().size())) {
+    animationTable = -1;
+  }
+}
@@ -7,36 +7,49 @@
 #include "../animation.hpp"
 #include "../../game.hpp"
 #include <SDL2/SDL.h>
+#include <functional>
 #include <map>
 #include <string>
 
+// Animations by name; std::less<> looks names up without building a
+// std::string
+using AnimationTable = std::map<std::string, Animation, std::less<>>;
+
 class SpriteComponent : public Component {
 private:
-  TransformComponent *transform;
-  SDL_Texture *texture;
+  TransformComponent *transform = nullptr;
+  TextureHandle texture = 0;
   SDL_Rect srcRect, destRect;
 
   bool animated = false;
   int frames = 0;
   int speed = 100;
+  int frame = 0; // Frame shown, to detect when the animation loops
 
 public:
   int animationIndex = 0;
-  std::map<std::string, Animation> animations;
+  // Index of the sprite's table among the ones built at startup, -1 for
+  // none: a prefab spawn and a snapshot copy the index, not the table
+  int animationTable = -1;
 
   SDL_RendererFlip spriteFlip = SDL_FLIP_NONE;
+  int layer = Game::layerPlayers; // Render layer of the sprite
+  // Added to the feet y the sprite is sorted by within its layer, e.g.
+  // negative for a shadow drawn under whoever stands on it
+  int sortOffset = 0;
 
   SpriteComponent() = default;
   SpriteComponent(const char *path);
   SpriteComponent(const char *path, bool isAnimated);
 
-  ~SpriteComponent();
-
   void setTexture(const char *path);
 
-  void init() override;
-  void update() override;
-  void draw() override;
+  void init();
+  void update();
+  void draw();
+
+  void save(SnapshotWriter &out) const;
+  void load(SnapshotReader &in);
 
   void play(const char *animName);
 
@@ -1,7 +1,8 @@
 #include "tile_component.hpp"
+#include "../../snapshot/snapshot.hpp"
 
 TileComponent::TileComponent(int srcX, int srcY, int xpos, int ypos, int tile_size, int tile_scale, const char *path) {
-    texture = TextureManager::LoadTexture(path);
+    texture = TextureManager::LoadTextureAsync(path);
 
     srcRect.x = srcX;
     srcRect.y = srcY;
@@ -15,20 +16,30 @@ TileComponent::TileComponent(int srcX, int srcY, int xpos, int ypos, int tile_si
     destRect.w = destRect.h = tile_size * tile_scale;
 }
 
-TileComponent::~TileComponent() {
-    if (texture) {
-        SDL_DestroyTexture(texture);
-        texture = nullptr;
+// Tiles are static entities, never updated: the screen position is derived
+// from the camera when drawing
+void TileComponent::draw() {
+    destRect.x = position.x - Game::camera.x;
+    destRect.y = position.y - Game::camera.y;
+
+    // Tiles of the map layer do not overlap: one sort y for all keeps them
+    // in map order, grouped by texture
+    if (texture != 0) {
+        Game::renderQueue.submit(texture, srcRect, destRect, SDL_FLIP_NONE,
+                                 Game::layerMap, 0);
     }
 }
 
-void TileComponent::update() {
-    destRect.x = position.x - Game::camera.x;
-    destRect.y = position.y - Game::camera.y;
+void TileComponent::save(SnapshotWriter &out) const {
+    out.write(texture);
+    out.write(srcRect);
+    out.write(destRect);
+    out.write(position);
 }
 
-void TileComponent::draw() {
-    if (texture) {
-        TextureManager::Draw(texture, srcRect, destRect, SDL_FLIP_NONE);
-    }
-}
\ No newline at end of file
+void TileComponent::load(SnapshotReader &in) {
+    in.read(texture);
+    in.read(srcRect);
+    in.read(destRect);
+    in.read(position);
+}
@@ -10,17 +10,17 @@
 class TileComponent : public Component {
 public:
 
-  SDL_Texture *texture; 
+  TextureHandle texture = 0;
   SDL_Rect srcRect, destRect;
   Vector2D position;
 
   TileComponent() = default;
   TileComponent(int srcX, int srcY, int xpos, int ypos, int tile_size, int tile_scale, const char *path);
 
-  ~TileComponent();
+  void draw();
 
-  void update() override;
-  void draw() override;
+  void save(SnapshotWriter &out) const;
+  void load(SnapshotReader &in);
 
 };
 
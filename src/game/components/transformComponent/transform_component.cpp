@@ -1,4 +1,6 @@
 #include "transform_component.hpp"
+#include "../../movementSystem/movement_system.hpp"
+#include "../../snapshot/snapshot.hpp"
 
 TransformComponent::TransformComponent() {
     position.Zero();
@@ -24,30 +26,32 @@ TransformComponent::TransformComponent(float x, float y, int h, int w, int s) {
     scale = s;
 }
 
+TransformComponent::~TransformComponent() {
+    MovementSystem::Unregister(this);
+}
+
+/**
+ * Integration is done for all transforms at once by the MovementSystem
+ */
 void TransformComponent::init() {
     velocity.Zero();
+    MovementSystem::Register(this);
 }
 
-void TransformComponent::update() {
-    position.x += TransformComponent::normalizeSpeed(speed, velocity.x);
-    position.y += TransformComponent::normalizeSpeed(speed, velocity.y);
+void TransformComponent::save(SnapshotWriter &out) const {
+    out.write(position);
+    out.write(velocity);
+    out.write(height);
+    out.write(width);
+    out.write(scale);
+    out.write(speed);
 }
 
-float TransformComponent::normalizeSpeed(float speed, float velocity) {
-    float normalizedSpeed = 0.0f;
-    float normalizer = 0.0f;
-    float magnitude = 0.0f;
-
-    magnitude = TransformComponent::getMagnitude();
-    speed *= velocity;
-    
-    // If the magnitude is zero, return the speed as is to avoid division by zero
-    if (magnitude == 0) {
-        return speed;
-    }
-
-    normalizer = std::abs(velocity / magnitude);
-
-    normalizedSpeed = speed * normalizer;
-    return normalizedSpeed;
-}
\ No newline at end of file
+void TransformComponent::load(SnapshotReader &in) {
+    in.read(position);
+    in.read(velocity);
+    in.read(height);
+    in.read(width);
+    in.read(scale);
+    in.read(speed);
+}
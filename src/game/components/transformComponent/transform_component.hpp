@@ -20,16 +20,20 @@ public:
   TransformComponent(int scale);
   TransformComponent(float x, float y, int h, int w, int s);
 
-  ~TransformComponent() override = default; // Default destructor
+  ~TransformComponent() override;
   
-  void init() override;
-  void update() override;
+  void init();
 
-  float normalizeSpeed(float speed, float velocity);
+  void save(SnapshotWriter &out) const;
+  void load(SnapshotReader &in);
 
-  float getMagnitude() const {
-    return std::sqrt(velocity.x * velocity.x + velocity.y * velocity.y);
-  }
+  float getMagnitude() const { return velocity.Length(); }
+
+private:
+  friend class MovementSystem;
+
+  // Position in the MovementSystem registry, so leaving it is O(1)
+  std::size_t movementSlot = static_cast<std::size_t>(-1);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,208 @@
+#include "debug_draw.hpp"
+#include "../game.hpp"
+#include <algorithm>
+#include <cmath>
+
+std::array<DebugDraw::Frame, 2> DebugDraw::frames;
+int DebugDraw::back = 0;
+std::size_t DebugDraw::drawCalls = 0;
+
+/**
+ * Start recording a new tick
+ */
+void DebugDraw::Begin() {
+  Frame &frame = frames[back];
+
+  // Keep the batches and their capacity, only drop the shapes
+  for (auto &batch : frame.batches) {
+    batch.rects.clear();
+    batch.fills.clear();
+    batch.lines.clear();
+    batch.points.clear();
+  }
+}
+
+/**
+ * Finish recording the tick: drop what lies outside the camera and move the
+ * rest to screen space, in place
+ * @param camera The camera of the tick's render commands
+ */
+void DebugDraw::End(const SDL_Rect &camera) {
+  auto cullRects = [&camera](std::vector<SDL_Rect> &rects) {
+    std::size_t kept = 0;
+    for (const SDL_Rect &world : rects) {
+      if (SDL_HasIntersection(&world, &camera) == SDL_TRUE) {
+        rects[kept++] = {world.x - camera.x, world.y - camera.y, world.w,
+                         world.h};
+      }
+    }
+    rects.resize(kept);
+  };
+
+  const float camX = static_cast<float>(camera.x);
+  const float camY = static_cast<float>(camera.y);
+  const SDL_FRect view = {camX, camY, static_cast<float>(camera.w),
+                          static_cast<float>(camera.h)};
+
+  for (auto &batch : frames[back].batches) {
+    cullRects(batch.rects);
+    cullRects(batch.fills);
+
+    // Six vertices per segment; a segment is kept whole if its quad meets
+    // the camera
+    auto &lines = batch.lines;
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i + 6 <= lines.size(); i += 6) {
+      float minX = lines[i].position.x, maxX = minX;
+      float minY = lines[i].position.y, maxY = minY;
+      for (std::size_t v = i + 1; v < i + 6; v++) {
+        minX = std::min(minX, lines[v].position.x);
+        maxX = std::max(maxX, lines[v].position.x);
+        minY = std::min(minY, lines[v].position.y);
+        maxY = std::max(maxY, lines[v].position.y);
+      }
+      if (maxX < view.x || minX > view.x + view.w || maxY < view.y ||
+          minY > view.y + view.h) {
+        continue;
+      }
+      for (std::size_t v = i; v < i + 6; v++) {
+        SDL_Vertex vertex = lines[v];
+        vertex.position.x -= camX;
+        vertex.position.y -= camY;
+        lines[kept++] = vertex;
+      }
+    }
+    lines.resize(kept);
+
+    auto &points = batch.points;
+    kept = 0;
+    for (const SDL_Point &world : points) {
+      if (world.x >= camera.x && world.x < camera.x + camera.w &&
+          world.y >= camera.y && world.y < camera.y + camera.h) {
+        points[kept++] = {world.x - camera.x, world.y - camera.y};
+      }
+    }
+    points.resize(kept);
+  }
+}
+
+void DebugDraw::Swap() { back = 1 - back; }
+
+/**
+ * Submit the front buffer: one SDL call per colour and primitive kind
+ */
+void DebugDraw::Flush() {
+  const Frame &frame = frames[1 - back];
+  drawCalls = 0;
+
+  Uint8 r, g, b, a;
+  SDL_GetRenderDrawColor(Game::renderer, &r, &g, &b, &a);
+  SDL_SetRenderDrawBlendMode(Game::renderer, SDL_BLENDMODE_BLEND);
+
+  for (const auto &batch : frame.batches) {
+    const SDL_Color &c = batch.color;
+    SDL_SetRenderDrawColor(Game::renderer, c.r, c.g, c.b, c.a);
+
+    if (!batch.fills.empty()) {
+      SDL_RenderFillRects(Game::renderer, batch.fills.data(),
+                          static_cast<int>(batch.fills.size()));
+      drawCalls++;
+    }
+    if (!batch.rects.empty()) {
+      SDL_RenderDrawRects(Game::renderer, batch.rects.data(),
+                          static_cast<int>(batch.rects.size()));
+      drawCalls++;
+    }
+    if (!batch.lines.empty()) {
+      SDL_RenderGeometry(Game::renderer, nullptr, batch.lines.data(),
+                         static_cast<int>(batch.lines.size()), nullptr, 0);
+      drawCalls++;
+    }
+    if (!batch.points.empty()) {
+      SDL_RenderDrawPoints(Game::renderer, batch.points.data(),
+                           static_cast<int>(batch.points.size()));
+      drawCalls++;
+    }
+  }
+
+  // Restore the clear colour
+  SDL_SetRenderDrawColor(Game::renderer, r, g, b, a);
+}
+
+void DebugDraw::Rect(const SDL_Rect &world, SDL_Color color) {
+  batchFor(color).rects.push_back(world);
+}
+
+void DebugDraw::FillRect(const SDL_Rect &world, SDL_Color color) {
+  batchFor(color).fills.push_back(world);
+}
+
+/**
+ * Record a 1px segment, drawn as a thin quad so all segments of a colour go
+ * out in a single SDL_RenderGeometry call
+ */
+void DebugDraw::Line(int x1, int y1, int x2, int y2, SDL_Color color) {
+  const float ax = static_cast<float>(x1) + 0.5f;
+  const float ay = static_cast<float>(y1) + 0.5f;
+  const float bx = static_cast<float>(x2) + 0.5f;
+  const float by = static_cast<float>(y2) + 0.5f;
+
+  // Half-pixel offset perpendicular to the segment
+  const float dx = bx - ax;
+  const float dy = by - ay;
+  const float length = std::sqrt(dx * dx + dy * dy);
+  const float nx = length > 0.0f ? -dy / length * 0.5f : 0.5f;
+  const float ny = length > 0.0f ? dx / length * 0.5f : 0.0f;
+
+  const SDL_FPoint noUv = {0.0f, 0.0f};
+  const SDL_Vertex v0 = {{ax + nx, ay + ny}, color, noUv};
+  const SDL_Vertex v1 = {{ax - nx, ay - ny}, color, noUv};
+  const SDL_Vertex v2 = {{bx + nx, by + ny}, color, noUv};
+  const SDL_Vertex v3 = {{bx - nx, by - ny}, color, noUv};
+
+  auto &lines = batchFor(color).lines;
+  lines.push_back(v0);
+  lines.push_back(v1);
+  lines.push_back(v2);
+  lines.push_back(v1);
+  lines.push_back(v3);
+  lines.push_back(v2);
+}
+
+void DebugDraw::Point(int x, int y, SDL_Color color) {
+  batchFor(color).points.push_back({x, y});
+}
+
+void DebugDraw::Cells(const SDL_Rect &area, int cellSize, SDL_Color color) {
+  if (cellSize <= 0 || area.w <= 0 || area.h <= 0) {
+    return;
+  }
+
+  const int firstX = area.x / cellSize;
+  const int firstY = area.y / cellSize;
+  const int lastX = (area.x + area.w - 1) / cellSize;
+  const int lastY = (area.y + area.h - 1) / cellSize;
+
+  for (int y = firstY; y <= lastY; y++) {
+    for (int x = firstX; x <= lastX; x++) {
+      Rect({x * cellSize, y * cellSize, cellSize, cellSize}, color);
+    }
+  }
+}
+
+std::size_t DebugDraw::DrawCalls() { return drawCalls; }
+
+DebugDraw::Batch &DebugDraw::batchFor(SDL_Color color) {
+  auto &batches = frames[back].batches;
+
+  // Only a handful of colours are ever used: a linear scan is enough
+  for (auto &batch : batches) {
+    const SDL_Color &c = batch.color;
+    if (c.r == color.r && c.g == color.g && c.b == color.b && c.a == color.a) {
+      return batch;
+    }
+  }
+
+  batches.push_back(Batch{color, {}, {}, {}, {}});
+  return batches.back();
+}
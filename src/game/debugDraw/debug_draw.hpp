@@ -0,0 +1,61 @@
+#ifndef DEBUG_DRAW_HPP
+#define DEBUG_DRAW_HPP
+
+#include <SDL2/SDL.h>
+#include <array>
+#include <vector>
+
+/**
+ * DebugDraw class
+ *
+ * Immediate-mode debug overlay. Shapes are given in world coordinates during
+ * the tick and grouped by colour. End() culls them against the camera the
+ * tick's sprites are drawn with, which is only known once the tick has moved
+ * it, and converts them to screen space. The render stage then issues one
+ * SDL call per colour and primitive kind, however many shapes were recorded.
+ *
+ * Like the RenderQueue it is double buffered: Begin(), the shape functions
+ * and End() run on the simulation thread, Flush() on the render stage,
+ * Swap() in between.
+ *
+ * @author: @iMeyu
+ */
+class DebugDraw {
+public:
+  static void Begin(); // Clear the back buffer
+  static void End(const SDL_Rect &camera);
+  static void Swap();
+  static void Flush(); // Main thread only
+
+  static void Rect(const SDL_Rect &world, SDL_Color color);
+  static void FillRect(const SDL_Rect &world, SDL_Color color);
+  static void Line(int x1, int y1, int x2, int y2, SDL_Color color);
+  static void Point(int x, int y, SDL_Color color);
+
+  // Outline every cell of a cellSize grid touched by area
+  static void Cells(const SDL_Rect &area, int cellSize, SDL_Color color);
+
+  static std::size_t DrawCalls(); // SDL calls issued by the last Flush()
+
+private:
+  // Everything recorded with one colour: in world space until End()
+  struct Batch {
+    SDL_Color color;
+    std::vector<SDL_Rect> rects;
+    std::vector<SDL_Rect> fills;
+    std::vector<SDL_Vertex> lines; // Two triangles per segment
+    std::vector<SDL_Point> points;
+  };
+
+  struct Frame {
+    std::vector<Batch> batches;
+  };
+
+  static std::array<Frame, 2> frames;
+  static int back;
+  static std::size_t drawCalls;
+
+  static Batch &batchFor(SDL_Color color);
+};
+
+#endif
@@ -0,0 +1,290 @@
+#include "debug_hud.hpp"
+#include "../../assetPack/asset_pack.hpp"
+#include "../../utility/logger/logger.hpp"
+#include "../../utility/utility.hpp"
+#include "../game.hpp"
+#include <SDL2/SDL_ttf.h>
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+SDL_Texture *DebugHud::atlas = nullptr;
+int DebugHud::atlasWidth = 1;
+int DebugHud::atlasHeight = 1;
+std::array<DebugHud::Glyph, DebugHud::glyphCount> DebugHud::glyphs{};
+int DebugHud::lineHeight = 0;
+std::vector<SDL_Vertex> DebugHud::vertices;
+std::vector<int> DebugHud::indices;
+std::array<HudStats, hudGraphFrames> DebugHud::history{};
+std::size_t DebugHud::newest = 0;
+double DebugHud::hudMs = 0.0;
+
+namespace {
+
+// Quads one frame of the HUD may hold: the panel, two graphs and the text
+constexpr std::size_t maxQuads = 1024;
+
+// Atlas rows are packed up to this width
+constexpr int atlasRowWidth = 256;
+
+// White block in the atlas corner; solid quads sample its inner texels so
+// filtering never reaches a glyph
+constexpr int whiteSize = 4;
+constexpr SDL_Rect whiteTexels = {1, 1, 2, 2};
+
+// Layout, in pixels
+constexpr float margin = 8.0f;
+constexpr float padding = 6.0f;
+constexpr float barWidth = 2.0f;
+constexpr float graphHeight = 32.0f;
+constexpr double graphMaxMs = 33.3; // Top of a graph: two 60 Hz frames
+constexpr double frameBudgetMs = 1000.0 / 60.0;
+
+constexpr SDL_Color panelColor = {0, 0, 0, 176};
+constexpr SDL_Color textColor = {255, 255, 255, 255};
+constexpr SDL_Color updateColor = {80, 160, 255, 255};
+constexpr SDL_Color renderColor = {255, 160, 64, 255};
+constexpr SDL_Color budgetColor = {255, 64, 64, 160};
+
+TTF_Font *openFont(const char *path, int pointSize, std::string &cooked) {
+  // The pack keeps the font as a raw entry; cooked must outlive the font
+  if (AssetPack::LoadText(path, cooked)) {
+    SDL_RWops *rw =
+        SDL_RWFromConstMem(cooked.data(), static_cast<int>(cooked.size()));
+    return rw ? TTF_OpenFontRW(rw, 1, pointSize) : nullptr;
+  }
+  return TTF_OpenFont(path, pointSize);
+}
+
+} // namespace
+
+/**
+ * Build the glyph atlas and the vertex buffers
+ * @param fontPath Font file, looked up in the asset pack first
+ * @param pointSize Size the glyphs are rasterised at
+ */
+bool DebugHud::Init(const char *fontPath, int pointSize) {
+  vertices.reserve(maxQuads * 4);
+  indices.clear();
+  indices.reserve(maxQuads * 6);
+  for (std::size_t q = 0; q < maxQuads; q++) {
+    const int v = static_cast<int>(q * 4);
+    indices.insert(indices.end(), {v, v + 1, v + 2, v + 2, v + 3, v});
+  }
+
+  TTF_Font *font = nullptr;
+  std::string cooked;
+  if (TTF_Init() != 0) {
+    LOG_WARNING("TTF_Init failed: %s", TTF_GetError());
+  } else {
+    font = openFont(fontPath, pointSize, cooked);
+    if (!font) {
+      LOG_WARNING("HUD font %s unavailable, drawing without text: %s",
+                  fontPath, TTF_GetError());
+    }
+  }
+
+  // Rasterise every glyph once and lay them out in rows after the white
+  // block
+  std::array<SDL_Surface *, glyphCount> rendered{};
+  int x = whiteSize + 1;
+  int y = 0;
+  int rowHeight = whiteSize;
+
+  for (std::size_t i = 0; font && i < glyphCount; i++) {
+    const Uint16 ch = static_cast<Uint16>(firstGlyph + i);
+    SDL_Surface *surface =
+        TTF_RenderGlyph_Blended(font, ch, {255, 255, 255, 255});
+    int minX, maxX, minY, maxY, advance = 0;
+    if (!surface || TTF_GlyphMetrics(font, ch, &minX, &maxX, &minY, &maxY,
+                                     &advance) != 0) {
+      if (surface) {
+        SDL_FreeSurface(surface);
+      }
+      continue;
+    }
+
+    if (x + surface->w > atlasRowWidth) {
+      x = 0;
+      y += rowHeight + 1;
+      rowHeight = 0;
+    }
+    glyphs[i] = {{x, y, surface->w, surface->h}, advance};
+    rendered[i] = surface;
+    x += surface->w + 1;
+    rowHeight = std::max(rowHeight, surface->h);
+  }
+
+  atlasWidth = atlasRowWidth;
+  atlasHeight = y + rowHeight;
+  lineHeight = font ? TTF_FontLineSkip(font) : 0;
+
+  SDL_Surface *pixels = SDL_CreateRGBSurfaceWithFormat(
+      0, atlasWidth, atlasHeight, 32, SDL_PIXELFORMAT_RGBA32);
+  if (pixels) {
+    const SDL_Rect white = {0, 0, whiteSize, whiteSize};
+    SDL_FillRect(pixels, &white, SDL_MapRGBA(pixels->format, 255, 255, 255, 255));
+
+    for (std::size_t i = 0; i < glyphCount; i++) {
+      if (rendered[i]) {
+        // Copy the coverage as alpha instead of blending it onto nothing
+        SDL_SetSurfaceBlendMode(rendered[i], SDL_BLENDMODE_NONE);
+        SDL_Rect dst = glyphs[i].src;
+        SDL_BlitSurface(rendered[i], nullptr, pixels, &dst);
+      }
+    }
+
+    atlas = SDL_CreateTextureFromSurface(Game::renderer, pixels);
+    SDL_FreeSurface(pixels);
+  }
+
+  for (SDL_Surface *surface : rendered) {
+    if (surface) {
+      SDL_FreeSurface(surface);
+    }
+  }
+  if (font) {
+    TTF_CloseFont(font);
+  }
+
+  if (!atlas) {
+    LOG_ERROR("Failed to create the HUD atlas: %s", SDL_GetError());
+    return false;
+  }
+  SDL_SetTextureBlendMode(atlas, SDL_BLENDMODE_BLEND);
+  SDL_SetTextureScaleMode(atlas, SDL_ScaleModeNearest);
+  return font != nullptr;
+}
+
+void DebugHud::Clean() {
+  if (atlas) {
+    SDL_DestroyTexture(atlas);
+    atlas = nullptr;
+  }
+  lineHeight = 0;
+  TTF_Quit();
+}
+
+void DebugHud::Record(const HudStats &stats) {
+  newest = (newest + 1) % history.size();
+  history[newest] = stats;
+}
+
+/**
+ * Write the overlay into the vertex buffer and draw it in one call
+ */
+void DebugHud::Flush() {
+  if (!atlas) {
+    return;
+  }
+
+  const Uint64 start = SDL_GetPerformanceCounter();
+  vertices.clear();
+
+  const HudStats &now = history[newest];
+  const int textLines = lineHeight > 0 ? 4 : 0;
+  const float width = static_cast<float>(hudGraphFrames) * barWidth;
+  const float textHeight = static_cast<float>(textLines * lineHeight);
+  const float left = margin + padding;
+  float top = margin + padding;
+
+  fill(margin, margin, width + 2.0f * padding,
+       textHeight + 2.0f * graphHeight + 3.0f * padding, panelColor);
+
+  if (textLines > 0) {
+    char line[96];
+    const float lh = static_cast<float>(lineHeight);
+
+    std::snprintf(line, sizeof(line), "frame %6.2f ms %5.0f fps", now.frameMs,
+                  now.frameMs > 0.0 ? 1000.0 / now.frameMs : 0.0);
+    text(left, top, line, textColor);
+
+    // Coloured like their graphs
+    std::snprintf(line, sizeof(line), "update %5.2f ms  ", now.updateMs);
+    const float next = text(left, top + lh, line, updateColor);
+    std::snprintf(line, sizeof(line), "render %5.2f ms", now.renderMs);
+    text(next, top + lh, line, renderColor);
+
+    std::snprintf(line, sizeof(line), "entities %zu  draw calls %zu",
+                  now.entities, now.drawCalls);
+    text(left, top + 2.0f * lh, line, textColor);
+
+    std::snprintf(line, sizeof(line), "textures %.2f MB  hud %.3f ms",
+                  static_cast<double>(now.textureBytes) / (1024.0 * 1024.0),
+                  hudMs);
+    text(left, top + 3.0f * lh, line, textColor);
+
+    top += textHeight + padding;
+  }
+
+  // One graph per stage, oldest frame on the left
+  for (int graph = 0; graph < 2; graph++) {
+    const SDL_Color color = graph == 0 ? updateColor : renderColor;
+    const float bottom = top + graphHeight;
+
+    for (std::size_t i = 0; i < hudGraphFrames; i++) {
+      const HudStats &frame = history[(newest + 1 + i) % hudGraphFrames];
+      const double ms = graph == 0 ? frame.updateMs : frame.renderMs;
+      const float h = static_cast<float>(std::min(ms / graphMaxMs, 1.0)) *
+                      graphHeight;
+      if (h > 0.0f) {
+        fill(left + static_cast<float>(i) * barWidth, bottom - h,
+             barWidth - 1.0f, h, color);
+      }
+    }
+
+    // The 60 Hz frame budget
+    const float budget =
+        static_cast<float>(frameBudgetMs / graphMaxMs) * graphHeight;
+    fill(left, bottom - budget, width, 1.0f, budgetColor);
+
+    top = bottom + padding;
+  }
+
+  const std::size_t quads = vertices.size() / 4;
+  SDL_RenderGeometry(Game::renderer, atlas, vertices.data(),
+                     static_cast<int>(vertices.size()), indices.data(),
+                     static_cast<int>(quads * 6));
+
+  hudMs = Utility::MsSince(start);
+}
+
+void DebugHud::quad(float x, float y, float w, float h, const SDL_Rect &src,
+                    SDL_Color color) {
+  if (vertices.size() + 4 > maxQuads * 4) {
+    return; // Full: the buffer was reserved once and never grows
+  }
+
+  const float u0 = static_cast<float>(src.x) / atlasWidth;
+  const float v0 = static_cast<float>(src.y) / atlasHeight;
+  const float u1 = static_cast<float>(src.x + src.w) / atlasWidth;
+  const float v1 = static_cast<float>(src.y + src.h) / atlasHeight;
+
+  vertices.push_back({{x, y}, color, {u0, v0}});
+  vertices.push_back({{x + w, y}, color, {u1, v0}});
+  vertices.push_back({{x + w, y + h}, color, {u1, v1}});
+  vertices.push_back({{x, y + h}, color, {u0, v1}});
+}
+
+void DebugHud::fill(float x, float y, float w, float h, SDL_Color color) {
+  quad(x, y, w, h, whiteTexels, color);
+}
+
+/**
+ * Write one line of text
+ * @return The pen position after the last glyph
+ */
+float DebugHud::text(float x, float y, const char *line, SDL_Color color) {
+  for (const char *c = line; *c; c++) {
+    if (*c < firstGlyph || *c > lastGlyph) {
+      continue;
+    }
+    const Glyph &glyph = glyphs[static_cast<std::size_t>(*c - firstGlyph)];
+    if (glyph.src.w > 0 && *c != ' ') {
+      quad(x, y, static_cast<float>(glyph.src.w),
+           static_cast<float>(glyph.src.h), glyph.src, color);
+    }
+    x += static_cast<float>(glyph.advance);
+  }
+  return x;
+}
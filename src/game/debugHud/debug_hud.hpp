@@ -0,0 +1,81 @@
+#ifndef DEBUG_HUD_HPP
+#define DEBUG_HUD_HPP
+
+#include <SDL2/SDL.h>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// Frames kept by the timing graph, one bar each
+constexpr std::size_t hudGraphFrames = 120;
+
+/**
+ * Figures of one frame shown by the HUD
+ */
+struct HudStats {
+  double frameMs = 0.0;  // Since the previous frame started rendering
+  double updateMs = 0.0; // Simulation of the tick being drawn
+  double renderMs = 0.0; // Submission of the tick, without the present
+  std::size_t entities = 0;
+  std::size_t drawCalls = 0;
+  std::size_t textureBytes = 0;
+};
+
+/**
+ * DebugHud class
+ *
+ * Performance overlay (F3): frame time, a graph of the update and render
+ * times of the last frames, entity and draw call counts, texture memory.
+ *
+ * Init() rasterises the printable ASCII glyphs of a font once into a single
+ * atlas texture, with a white block for solid quads. Every frame the panel,
+ * the graph and the text are written as quads into one vertex buffer and
+ * drawn with a single SDL_RenderGeometry call: no text is rendered, no
+ * texture created and nothing allocated while the HUD runs. Without the
+ * font the text is left out and the graph still works.
+ *
+ * Main thread only.
+ *
+ * @author: @iMeyu
+ */
+class DebugHud {
+public:
+  // After the renderer; false if the font could not be used
+  static bool Init(const char *fontPath, int pointSize);
+  static void Clean();
+
+  static void Record(const HudStats &stats); // Once per frame, drawn or not
+  static void Flush();                       // Draw the overlay
+
+private:
+  // First and last glyph in the atlas
+  static constexpr char firstGlyph = ' ';
+  static constexpr char lastGlyph = '~';
+  static constexpr std::size_t glyphCount = lastGlyph - firstGlyph + 1;
+
+  struct Glyph {
+    SDL_Rect src; // In the atlas
+    int advance;
+  };
+
+  static void quad(float x, float y, float w, float h, const SDL_Rect &src,
+                   SDL_Color color);
+  static void fill(float x, float y, float w, float h, SDL_Color color);
+  static float text(float x, float y, const char *line, SDL_Color color);
+
+  static SDL_Texture *atlas;
+  static int atlasWidth;
+  static int atlasHeight;
+  static std::array<Glyph, glyphCount> glyphs;
+  static int lineHeight; // 0 without a font
+
+  static std::vector<SDL_Vertex> vertices; // Reserved by Init
+  static std::vector<int> indices;         // Two triangles per quad
+
+  // Ring of the last frames for the graph
+  static std::array<HudStats, hudGraphFrames> history;
+  static std::size_t newest;
+  static double hudMs; // Time the last Flush() took
+};
+
+#endif
@@ -0,0 +1,35 @@
+#include "event_bus.hpp"
+
+namespace {
+
+// Events of one type a tick can hold before its queue grows. Reserved up
+// front: some kinds (collisions, finished animations) first happen long
+// after the game started.
+constexpr std::size_t initialQueueCapacity = 64;
+
+} // namespace
+
+/**
+ * The queues.
+ * Never destroyed, and created on first use: global entities are spawned
+ * during static initialization, possibly before this file's statics.
+ */
+EventQueues &EventBus::queues() {
+  static auto *eventQueues = [] {
+    auto *created = new EventQueues();
+    std::apply(
+        [](auto &...queue) { (queue.reserve(initialQueueCapacity), ...); },
+        *created);
+    return created;
+  }();
+  return *eventQueues;
+}
+
+void EventBus::Reserve(std::size_t events) {
+  std::apply([events](auto &...queue) { (queue.reserve(events), ...); },
+             queues());
+}
+
+void EventBus::Clear() {
+  std::apply([](auto &...queue) { (queue.clear(), ...); }, queues());
+}
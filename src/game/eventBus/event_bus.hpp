@@ -0,0 +1,54 @@
+#ifndef EVENT_BUS_HPP
+#define EVENT_BUS_HPP
+
+#include "events.hpp"
+#include <tuple>
+#include <vector>
+
+// One contiguous queue per event type
+template <typename List> struct EventQueuesOf;
+
+template <typename... Ts> struct EventQueuesOf<TypeList<Ts...>> {
+  using type = std::tuple<std::vector<Ts>...>;
+};
+
+using EventQueues = EventQueuesOf<EventTypes>::type;
+
+/**
+ * EventBus class
+ *
+ * Producers append events to the queue of their type; consumers read a
+ * whole queue at once wherever the tick handles that kind of event. Clear()
+ * empties every queue at the start of the tick but keeps their storage, so
+ * after the first ticks emitting allocates nothing.
+ *
+ * Simulation thread only (or before the simulation thread starts).
+ *
+ * @author: @iMeyu
+ */
+class EventBus {
+public:
+  template <typename E> static void Emit(const E &event) {
+    queue<E>().push_back(event);
+  }
+
+  // Every event of type E emitted so far this tick, in emission order
+  template <typename E> static const std::vector<E> &Events() {
+    return queue<E>();
+  }
+
+  static void Clear();
+  // Room for this many events of each type per tick
+  static void Reserve(std::size_t events);
+
+private:
+  template <typename E> static std::vector<E> &queue() {
+    static_assert(TypeListContains<E, EventTypes>::value,
+                  "Event type missing from EventTypes in events.hpp");
+    return std::get<std::vector<E>>(queues());
+  }
+
+  static EventQueues &queues();
+};
+
+#endif
@@ -0,0 +1,54 @@
+// events.hpp
+// Every event type carried by the EventBus.
+// Events are plain data. Entity pointers stay valid until the end of the
+// tick the event was emitted in.
+#ifndef EVENTS_HPP
+#define EVENTS_HPP
+
+#include "../ECS/registry.hpp"
+#include "../timerWheel/timer_wheel.hpp"
+#include "../vector2d/vector_2d.hpp"
+#include <SDL2/SDL.h>
+
+class Entity;
+
+// An entity overlapped another; push separates them
+struct CollisionEvent {
+  Entity *entity;
+  Entity *other;
+  SDL_Rect contact;
+  Vector2D push;
+};
+
+struct EntitySpawnedEvent {
+  Entity *entity;
+};
+
+struct EntityDestroyedEvent {
+  Entity *entity; // Removed from the manager at the next refresh
+};
+
+// An animation played its last frame and started over
+struct AnimationFinishedEvent {
+  Entity *entity;
+  int animationIndex;
+};
+
+// An entity started or stopped moving
+struct MovementChangedEvent {
+  Entity *entity;
+  bool moving;
+};
+
+// A timer of Manager::addTimer came due; tag is the one it was given
+struct TimerEvent {
+  Entity *entity;
+  std::uint32_t tag;
+  TimerId timer;
+};
+
+using EventTypes =
+    TypeList<CollisionEvent, EntitySpawnedEvent, EntityDestroyedEvent,
+             AnimationFinishedEvent, MovementChangedEvent, TimerEvent>;
+
+#endif
@@ -0,0 +1,181 @@
+#include "flow_field.hpp"
+#include "../../utility/threadPool/thread_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+namespace {
+
+// Neighbour offsets: the 4 sides first, so ties prefer straight steps
+constexpr int neighbourX[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+constexpr int neighbourY[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+
+constexpr std::uint8_t noDirection = 8;
+
+} // namespace
+
+FlowField::~FlowField() {
+  // The worker writes into back
+  if (pending.valid()) {
+    pending.wait();
+  }
+}
+
+void FlowField::SetGrid(const std::vector<std::uint8_t> &cells, int w, int h,
+                        int size) {
+  if (pending.valid()) {
+    pending.wait();
+  }
+
+  solid = cells;
+  width = w;
+  height = h;
+  cellSize = size > 0 ? size : 1;
+
+  // Sized once here so rebuilds never allocate
+  const std::size_t count = static_cast<std::size_t>(width) * height;
+  for (Fields *fields : {&front, &back}) {
+    fields->cost.assign(count, flowUnreachable);
+    fields->direction.assign(count, noDirection);
+    fields->frontier.resize(count);
+    fields->goal = -1;
+  }
+  wantedGoal = -1;
+}
+
+/**
+ * Aim the fields at a world position. Nothing is rebuilt while the position
+ * stays in the same cell.
+ */
+void FlowField::SetGoal(float x, float y) {
+  const int goal = cellAt(x, y);
+  if (goal < 0 || goal == wantedGoal) {
+    return;
+  }
+  wantedGoal = goal;
+
+  if (!workers) {
+    build(front, goal);
+    return;
+  }
+  if (!pending.valid()) {
+    startBuild(goal);
+  }
+  // Otherwise Update() starts it once the running rebuild is published
+}
+
+void FlowField::Update() {
+  if (!pending.valid() ||
+      pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+    return;
+  }
+
+  pending.get();
+  std::swap(front, back);
+
+  // The goal moved on while the worker was busy
+  if (front.goal != wantedGoal) {
+    startBuild(wantedGoal);
+  }
+}
+
+void FlowField::startBuild(int goal) {
+  pending = workers->submit([this, goal] { build(back, goal); });
+}
+
+/**
+ * Breadth-first integration from the goal, then the direction of every
+ * reached cell
+ */
+void FlowField::build(Fields &fields, int goal) const {
+  std::fill(fields.cost.begin(), fields.cost.end(), flowUnreachable);
+
+  // The goal itself may be solid (an agent standing against a wall); it is
+  // still the source, only its free neighbours are expanded
+  std::size_t head = 0;
+  std::size_t tail = 0;
+  fields.cost[goal] = 0;
+  fields.frontier[tail++] = goal;
+
+  while (head < tail) {
+    const int cell = fields.frontier[head++];
+    const int cx = cell % width;
+    const int cy = cell / width;
+    const std::uint16_t next = fields.cost[cell] + 1;
+
+    for (int k = 0; k < 4; k++) {
+      const int nx = cx + neighbourX[k];
+      const int ny = cy + neighbourY[k];
+      if (nx < 0 || ny < 0 || nx >= width || ny >= height) {
+        continue;
+      }
+      const int n = ny * width + nx;
+      if (solid[n] || fields.cost[n] != flowUnreachable) {
+        continue;
+      }
+      fields.cost[n] = next;
+      fields.frontier[tail++] = n;
+    }
+  }
+
+  for (int cy = 0; cy < height; cy++) {
+    for (int cx = 0; cx < width; cx++) {
+      const int cell = cy * width + cx;
+      std::uint8_t best = noDirection;
+      std::uint16_t bestCost = fields.cost[cell];
+
+      if (!solid[cell] && bestCost != flowUnreachable) {
+        for (int k = 0; k < 8; k++) {
+          const int nx = cx + neighbourX[k];
+          const int ny = cy + neighbourY[k];
+          if (nx < 0 || ny < 0 || nx >= width || ny >= height) {
+            continue;
+          }
+          // No corner cutting: both sides of a diagonal must be free
+          if (k >= 4 && (solid[cy * width + nx] || solid[ny * width + cx])) {
+            continue;
+          }
+          const std::uint16_t cost = fields.cost[ny * width + nx];
+          if (cost < bestCost) {
+            bestCost = cost;
+            best = static_cast<std::uint8_t>(k);
+          }
+        }
+      }
+
+      fields.direction[cell] = best;
+    }
+  }
+
+  fields.goal = goal;
+}
+
+Vector2D FlowField::Direction(float x, float y) const {
+  const int cell = cellAt(x, y);
+  if (cell < 0 || front.goal < 0 || front.direction[cell] == noDirection) {
+    return {};
+  }
+  const std::uint8_t step = front.direction[cell];
+  return {static_cast<float>(neighbourX[step]),
+          static_cast<float>(neighbourY[step])};
+}
+
+std::uint16_t FlowField::Cost(int cellX, int cellY) const {
+  if (front.goal < 0 || cellX < 0 || cellY < 0 || cellX >= width ||
+      cellY >= height) {
+    return flowUnreachable;
+  }
+  return front.cost[cellY * width + cellX];
+}
+
+int FlowField::cellAt(float x, float y) const {
+  if (x < 0.0f || y < 0.0f) {
+    return -1;
+  }
+  const int cx = static_cast<int>(x) / cellSize;
+  const int cy = static_cast<int>(y) / cellSize;
+  if (cx >= width || cy >= height) {
+    return -1;
+  }
+  return cy * width + cx;
+}
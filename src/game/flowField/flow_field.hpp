@@ -0,0 +1,79 @@
+#ifndef FLOW_FIELD_HPP
+#define FLOW_FIELD_HPP
+
+#include "../vector2d/vector_2d.hpp"
+#include <cstdint>
+#include <future>
+#include <vector>
+
+class ThreadPool;
+
+// Integration cost of a cell with no path to the goal
+constexpr std::uint16_t flowUnreachable = 0xFFFF;
+
+/**
+ * FlowField class
+ *
+ * Paths from every cell of the map to one goal, shared by all the agents
+ * heading there. The integration field holds the number of steps from each
+ * free cell to the goal cell (breadth first over the 4 neighbours); the
+ * direction field stores, per cell, the neighbour with the lowest cost among
+ * the 8 around it, diagonals only when neither side is solid. An agent's step
+ * is one lookup, however many agents there are.
+ *
+ * The fields are rebuilt only when the goal enters another cell. Given a
+ * ThreadPool the rebuild runs on a worker into a second set of fields that
+ * Update() publishes once done; until then agents follow the previous ones.
+ *
+ * @author: @iMeyu
+ */
+class FlowField {
+public:
+  FlowField() = default;
+  explicit FlowField(ThreadPool *workers) : workers(workers) {}
+  ~FlowField();
+
+  FlowField(const FlowField &) = delete;
+  FlowField &operator=(const FlowField &) = delete;
+
+  // Copy the solid cells (row major, non-zero is solid); drops the goal
+  void SetGrid(const std::vector<std::uint8_t> &solid, int width, int height,
+               int cellSize);
+
+  void SetGoal(float x, float y); // World position
+  void Update(); // Publish a finished rebuild, start a pending one
+
+  // Step toward the goal from a world position, -1, 0 or 1 per axis like
+  // keyboard input: the movement integration normalises diagonals. Zero in
+  // the goal cell, in solid cells and where the goal cannot be reached
+  Vector2D Direction(float x, float y) const;
+  std::uint16_t Cost(int cellX, int cellY) const;
+
+  bool IsReady() const { return front.goal >= 0; } // Fields were built
+
+private:
+  struct Fields {
+    std::vector<std::uint16_t> cost;
+    std::vector<std::uint8_t> direction; // Neighbour index, noDirection if none
+    std::vector<int> frontier;           // Breadth-first queue
+    int goal = -1;                       // Cell the fields lead to
+  };
+
+  void build(Fields &fields, int goal) const;
+  void startBuild(int goal);
+  int cellAt(float x, float y) const; // -1 outside the grid
+
+  std::vector<std::uint8_t> solid;
+  int width = 0;
+  int height = 0;
+  int cellSize = 1;
+
+  Fields front; // Read by agents
+  Fields back;  // Written by the rebuild
+
+  ThreadPool *workers = nullptr;
+  std::future<void> pending; // Worker rebuild of back
+  int wantedGoal = -1;       // Latest goal cell asked for
+};
+
+#endif
@@ -1,30 +1,78 @@
 #include "../game/game.hpp"
+#include "../game/behaviour/behaviour.hpp"
+#include "../game/behaviour/behaviour_scripts.hpp"
+#include "../game/collision/collider_grid.hpp"
 #include "../game/collision/collision.hpp"
 #include "../game/components/colliderComponent/collider_component.hpp"
 #include "../game/components/keyboardComponent/keyboard_controller.hpp"
+#include "../game/components/particleEmitterComponent/particle_emitter_component.hpp"
 #include "../game/components/spriteComponent/sprite_component.hpp"
+#include "../game/debugDraw/debug_draw.hpp"
+#include "../game/debugHud/debug_hud.hpp"
+#include "../game/eventBus/event_bus.hpp"
+#include "../game/flowField/flow_field.hpp"
 #include "../game/map/map.hpp"
+#include "../game/particleSystem/particle_system.hpp"
+#include "../game/prefab/prefab.hpp"
+#include "../game/raycast/grid_raycast.hpp"
+#include "../game/movementSystem/movement_system.hpp"
+#include "../game/simulationLod/simulation_lod.hpp"
+#include "../assetPack/asset_pack.hpp"
 #include "../game/vector2d/vector_2d.hpp"
+#include "../textureManager/texture_manager.hpp"
+#include "../utility/allocTracker/alloc_tracker.hpp"
+#include "../utility/logger/logger.hpp"
 #include "../utility/utility.hpp"
+#include <array>
 #include <memory>
 
 Manager manager;
 std::unique_ptr<Map> map; // The map object
+FlowField playerField;    // Paths to the player, for NavigationComponent
+ColliderGrid colliderGrid; // Broadphase of detectCollisions
 
 SDL_Renderer *Game::renderer = nullptr;   // The renderer of the game
 SDL_Event Game::event;                    // The event of the game
 SDL_Rect Game::camera = {0, 0, 800, 640}; // The camera of the game
+RenderQueue Game::renderQueue;            // Render commands of the game
 
-auto &tiles(manager.getGroup(Game::groupMap));
-auto &players(manager.getGroup(Game::groupPlayers));
-auto &colliders(manager.getGroup(Game::groupColliders));
+auto &tiles(manager.getGroup(groupMap));
+auto &players(manager.getGroup(groupPlayers));
+auto &colliders(manager.getGroup(groupColliders));
 
 auto &player(manager.addEntity());
 auto &follower(manager.addEntity());
 auto &follower2(manager.addEntity());
 
+// Time per frame the main thread may spend uploading textures
+constexpr double uploadBudgetMs = 2.0;
+
+// Colours of the collision overlay shapes recorded by the game itself
+constexpr SDL_Color debugCellColor = {64, 128, 255, 255};
+constexpr SDL_Color debugContactColor = {255, 220, 0, 160};
+constexpr SDL_Color debugRayColor = {255, 255, 255, 96};
+
+// Rays of the player's line-of-sight overlay
+constexpr float sightDistance = 400.0f;
+static std::array<RayHit, 64> sightHits;
+
+// Broadphase results of detectCollisions, reused every tick
+static std::vector<ColliderComponent *> candidates;
+
+// Cooked assets produced by the AssetCooker target
+constexpr const char *assetPackPath = "assets.pak";
+
+// Font of the performance HUD, DejaVu Sans Mono (see its license file next
+// to it); without it the HUD has no text
+constexpr const char *hudFontPath = "assets/fonts/DejaVuSansMono.ttf";
+constexpr int hudFontSize = 14;
+
 bool Game::isRunning = false;     // Whether the game is running
 bool Game::showColliders = false; // Whether to show colliders
+bool Game::showHud = false;       // Whether to show the performance HUD
+bool Game::headless = false;      // Whether to run without a visible window
+int Game::renderScale = 1;        // Window pixels per world pixel drawn
+int Game::spawnAgents = 0;        // Load test agents, none by default
 
 // Constructor and Destructor
 Game::Game() {}
@@ -48,10 +96,16 @@ void Game::init(const char *title, int xpos, int ypos, int width, int height,
   if (fullscreen) {
     flags = SDL_WINDOW_FULLSCREEN;
   }
+  if (headless) {
+    flags = SDL_WINDOW_HIDDEN;
+  }
+
+  Logger::Init();
+  loadStart = SDL_GetPerformanceCounter();
 
   // Initialize SDL
   if (SDL_Init(SDL_INIT_EVERYTHING) != 0) {
-    Utility::Log("SDL_Init failed");
+    LOG_ERROR("SDL_Init failed: %s", SDL_GetError());
     isRunning = false;
     return;
   }
@@ -59,7 +113,7 @@ void Game::init(const char *title, int xpos, int ypos, int width, int height,
   // Initialize SDL_image for PNG support
   const int imgFlags = IMG_INIT_PNG;
   if ((IMG_Init(imgFlags) & imgFlags) != imgFlags) {
-    Utility::Log("IMG_Init failed: " + std::string(IMG_GetError()));
+    LOG_WARNING("IMG_Init failed: %s", IMG_GetError());
     // Not fatal for now; textures will fail to load and log accordingly
   }
 
@@ -68,25 +122,76 @@ void Game::init(const char *title, int xpos, int ypos, int width, int height,
 
   // Check if the window was created
   if (!window) {
-    Utility::Log("Failed to create window");
+    LOG_ERROR("Failed to create window: %s", SDL_GetError());
     isRunning = false;
     return;
   }
 
-  // Create the renderer (accelerated + vsync)
-  renderer = SDL_CreateRenderer(
-      window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+  // Create the renderer (accelerated + vsync, software when headless so
+  // replays run as fast as the simulation allows)
+  const Uint32 rendererFlags =
+      headless ? SDL_RENDERER_SOFTWARE
+               : SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC;
+
+  // Render targets are only needed for the world target. Without them the
+  // renderer is created anyway, and the world drawn at full resolution.
+  if (renderScale > 1) {
+    renderer = SDL_CreateRenderer(window, -1,
+                                  rendererFlags | SDL_RENDERER_TARGETTEXTURE);
+    if (!renderer) {
+      LOG_WARNING("No renderer with render targets, rendering at full "
+                  "resolution: %s",
+                  SDL_GetError());
+      renderScale = 1;
+    }
+  }
+  if (!renderer) {
+    renderer = SDL_CreateRenderer(window, -1, rendererFlags);
+  }
 
   // Check if the renderer was created
   if (!renderer) {
-    Utility::Log("Failed to create renderer");
+    LOG_ERROR("Failed to create renderer: %s", SDL_GetError());
     isRunning = false;
     return;
   }
 
+  // The world target covers the window at renderScale, rounded up; the
+  // upscale is an integer factor, so every world pixel becomes a square
+  if (renderScale > 1) {
+    const int targetWidth = (width + renderScale - 1) / renderScale;
+    const int targetHeight = (height + renderScale - 1) / renderScale;
+    worldTarget =
+        SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+                          SDL_TEXTUREACCESS_TARGET, targetWidth, targetHeight);
+    if (worldTarget) {
+      SDL_SetTextureScaleMode(worldTarget, SDL_ScaleModeNearest);
+      upscaled = {0, 0, targetWidth * renderScale, targetHeight * renderScale};
+      LOG_INFO("World rendered at %dx%d, upscaled %dx", targetWidth,
+               targetHeight, renderScale);
+    } else {
+      LOG_WARNING("Failed to create the world target, rendering at full "
+                  "resolution: %s",
+                  SDL_GetError());
+      renderScale = 1;
+    }
+  }
+
   // Set the renderer draw color to black
   SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
 
+  // Prefer the cooked pack; loose files under assets/ are the fallback
+  if (AssetPack::Open(assetPackPath)) {
+    LOG_INFO("Using asset pack %s", assetPackPath);
+  } else {
+    LOG_INFO("No asset pack, loading loose files");
+  }
+
+  // Start the texture decode workers; loads below return immediately
+  TextureManager::Init();
+
+  DebugHud::Init(hudFontPath, hudFontSize);
+
   // Set the game to running
   isRunning = true;
 
@@ -106,72 +211,269 @@ void Game::init(const char *title, int xpos, int ypos, int width, int height,
 
   map = std::make_unique<Map>("assets/maps/lvl1-tiles.png", map_scale,
                               map_tile_size);
+  const Uint64 levelStart = SDL_GetPerformanceCounter();
   map->LoadMap("assets/maps/lvl1.map", mapSizeX, mapSizeY);
+  LOG_INFO("Level built in %.3f ms", Utility::MsSince(levelStart));
+
+  SimulationLod::Configure(manager, LodSettings{});
+
+  // Small enough to rebuild inline when the player changes cell
+  playerField.SetGrid(map->GetSolid(), map->GetWidth(), map->GetHeight(),
+                      map->GetScaledSize());
+  GridRaycast::SetGrid(map->GetSolid(), map->GetWidth(), map->GetHeight(),
+                       map->GetScaledSize());
+  colliderGrid.SetGrid(map->GetWidth(), map->GetHeight(),
+                       map->GetScaledSize());
+  candidates.reserve(64);
+
+  // Scripts BehaviourComponent can run, by name
+  BehaviourScripts::RegisterAll();
 
   player.addComponent<TransformComponent>(player_scale);
   player.addComponent<SpriteComponent>("assets/pg1-Sheet.png", is_animated);
   player.addComponent<KeyboardController>();
   player.addComponent<ColliderComponent>("player", 0, 0, 32, 16, 0, 16);
 
+  // Dust at the player's feet while walking: a soft white dot, tinted by
+  // the emitter's colours
+  auto &dust = player.addComponent<ParticleEmitterComponent>(
+      "assets/particle.png", 30.0f, 0.4f);
+  dust.active = false;
+  dust.speed = 20.0f;
+  dust.size = 3.0f;
+  dust.offsetX = 16.0f;
+  dust.offsetY = 30.0f;
+  dust.startColor = {200, 180, 150, 200};
+  dust.endColor = {200, 180, 150, 0};
+
   follower.addGroup(groupPlayers);
   follower2.addGroup(groupPlayers);
   player.addGroup(groupPlayers);
+
+  // Load test: agents walking back and forth, stamped out of one prefab on
+  // a grid over the map
+  if (spawnAgents > 0) {
+    Prefab agent;
+    agent.add<TransformComponent>(0.0f, 0.0f, 32, 32, 1);
+    agent.add<SpriteComponent>("assets/pg1-Sheet.png", is_animated);
+    agent.add<BehaviourComponent>("patrol");
+
+    constexpr int spacing = 16;
+    const int columns =
+        std::max(map->GetWidth() * map->GetScaledSize() / spacing, 1);
+    const int rows =
+        std::max(map->GetHeight() * map->GetScaledSize() / spacing, 1);
+
+    const Uint64 spawnStart = SDL_GetPerformanceCounter();
+    manager.spawnBatch(agent, static_cast<std::size_t>(spawnAgents),
+                       [columns, rows](Entity &e, std::size_t i) {
+                         const int cell = static_cast<int>(i);
+                         e.getComponent<TransformComponent>().position = {
+                             static_cast<float>(cell % columns * spacing),
+                             static_cast<float>(cell / columns % rows *
+                                                spacing)};
+                       });
+    LOG_INFO("Spawned %d agents in %.3f ms", spawnAgents,
+             Utility::MsSince(spawnStart));
+  }
+
+  simulationThread = std::thread(&Game::simulationLoop, this);
 }
 
 /**
- * Update the game
+ * Start the next tick on the simulation thread.
+ * Runs inline if the simulation thread is not available.
  */
 void Game::update() {
-  manager.refresh();
-  manager.update();
+  if (!simulationThread.joinable()) {
+    simulate();
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(simulationMutex);
+    tickRequested = true;
+  }
+  simulationCv.notify_one();
+}
+
+/**
+ * Wait until the running tick has finished, then hand its render commands
+ * to the render stage.
+ */
+void Game::sync() {
+  if (simulationThread.joinable()) {
+    std::unique_lock<std::mutex> lock(simulationMutex);
+    simulationCv.wait(lock, [this] { return !tickRequested; });
+  }
+
+  // The tick just finished is the one the next frame draws
+  hudStats.updateMs = simulateMs;
+  hudStats.entities = manager.entityCount();
+
+  renderQueue.swap();
+  ParticleSystem::Swap();
+  DebugDraw::Swap();
+}
+
+/**
+ * Body of the simulation thread: waits for a tick request, simulates it and
+ * signals completion. It never calls the SDL renderer.
+ */
+void Game::simulationLoop() {
+  std::unique_lock<std::mutex> lock(simulationMutex);
+
+  while (true) {
+    simulationCv.wait(lock, [this] { return tickRequested || stopSimulation; });
+    if (stopSimulation) {
+      return;
+    }
+
+    lock.unlock();
+    simulate();
+    lock.lock();
+
+    tickRequested = false;
+    simulationCv.notify_one();
+  }
+}
+
+/**
+ * Simulate one tick of the game and record its render commands
+ */
+void Game::simulate() {
+  AllocScope allocScope(AllocTag::Simulation);
+  const Uint64 simulateStart = SDL_GetPerformanceCounter();
+
+  // Events live for one tick; the queues keep their storage
+  EventBus::Clear();
+  {
+    AllocScope ecsScope(AllocTag::ECS);
+    manager.refresh();
+  }
+
+  // Debug shapes are recorded in world space until the tick has placed the
+  // camera
+  DebugDraw::Begin();
+
+  // Loading a snapshot replaces the tick instead of simulating it
+  const InputSnapshot &input = Input::Current();
+  if (input.wasPressed(Action::QuickLoad) && !quickSave.empty()) {
+    WorldSnapshot::Restore(manager, camera, quickSave);
+    LOG_INFO("Quick load");
+  } else if (input.isHeld(Action::Rewind) && history.StepBack(snapshot)) {
+    WorldSnapshot::Restore(manager, camera, snapshot);
+  } else {
+    step();
+
+    AllocScope snapshotScope(AllocTag::Snapshot);
+    const Uint64 captureStart = SDL_GetPerformanceCounter();
+    WorldSnapshot::Capture(manager, camera, snapshot);
+    history.Push(snapshot);
+    if (input.wasPressed(Action::QuickSave)) {
+      quickSave = snapshot;
+      LOG_INFO("Quick save: %zu bytes captured in %.3f ms, %zu ticks of "
+               "history in %zu bytes",
+               quickSave.size(), Utility::MsSince(captureStart),
+               history.Size(), history.Bytes());
+    }
+  }
+
+  // Particles are culled against the camera of this tick
+  {
+    AllocScope particleScope(AllocTag::Particles);
+    ParticleSystem::Update(camera);
+  }
+
+  // Record the draw calls of this tick; components only emit commands. The
+  // queue orders them by layer and sort y, not by the order of these loops.
+  renderQueue.begin(camera);
+
+  for (auto &tile : tiles) {
+    tile->draw();
+  }
+
+  for (auto &player : players) {
+    player->draw();
+  }
+
+  // Terrain colliders belong to no drawn group; the player's collider is
+  // already drawn with its entity
+  if (showColliders) {
+    for (auto &collider : colliders) {
+      collider->draw();
+    }
+  }
+  DebugDraw::End(camera);
+
+  manager.endTick();
+  simulateMs = Utility::MsSince(simulateStart);
+}
+
+/**
+ * Run the game logic of one tick
+ */
+void Game::step() {
+  // Integrate all transforms first, as each entity's transform used to
+  // update before its other components. What updates at all depends on the
+  // distance to the camera of the previous tick.
+  {
+    AllocScope ecsScope(AllocTag::ECS);
+    manager.beginTick();
+    SimulationLod::Update(manager, camera);
+    MovementSystem::Update();
+    manager.update();
+  }
+
+  {
+    AllocScope collisionScope(AllocTag::Collision);
+    colliderGrid.Update(manager); // Colliders follow this tick's movement
+    detectCollisions();
+    resolveCollisions();
+    SimulationLod::WakeOnEvents();
+  }
+
+  {
+    // After the events of this tick, which the behaviours may wait for
+    AllocScope behaviourScope(AllocTag::Behaviours);
+    BehaviourScheduler::Update(manager);
+  }
+
+  // Switch animations of the entities that started or stopped moving,
+  // behaviours included
+  for (const auto &moved : EventBus::Events<MovementChangedEvent>()) {
+    if (moved.entity->hasComponent<SpriteComponent>()) {
+      moved.entity->getComponent<SpriteComponent>().play(moved.moving ? "walk"
+                                                                       : "idle");
+    }
+    if (moved.entity->hasComponent<ParticleEmitterComponent>()) {
+      moved.entity->getComponent<ParticleEmitterComponent>().active =
+          moved.moving;
+    }
+  }
 
   auto &pt = player.getComponent<TransformComponent>();
 
-  // Usa il collider del player SOLO se presente, altrimenti nessuna collisione
+  // The player's feet if it has a collider, else the centre of its sprite
+  Vector2D eye(pt.position.x + pt.width * pt.scale * 0.5f,
+               pt.position.y + pt.height * pt.scale * 0.5f);
   if (player.hasComponent<ColliderComponent>()) {
-    SDL_Rect playerRect = player.getComponent<ColliderComponent>().collider;
+    const SDL_Rect &feet = player.getComponent<ColliderComponent>().collider;
+    eye = Vector2D(feet.x + feet.w * 0.5f, feet.y + feet.h * 0.5f);
+  }
 
-    for (auto &collider : colliders) {
-      const SDL_Rect cCol =
-          collider->getComponent<ColliderComponent>().collider;
-
-      if (Collision::AABB(playerRect, cCol)) {
-        const float px = static_cast<float>(playerRect.x);
-        const float py = static_cast<float>(playerRect.y);
-        const float pw = static_cast<float>(playerRect.w);
-        const float ph = static_cast<float>(playerRect.h);
-
-        const float ox = static_cast<float>(cCol.x);
-        const float oy = static_cast<float>(cCol.y);
-        const float ow = static_cast<float>(cCol.w);
-        const float oh = static_cast<float>(cCol.h);
-
-        const float pCx = px + pw * 0.5f;
-        const float pCy = py + ph * 0.5f;
-        const float oCx = ox + ow * 0.5f;
-        const float oCy = oy + oh * 0.5f;
-
-        const float deltaX = pCx - oCx;
-        const float deltaY = pCy - oCy;
-
-        const float absDX = (deltaX < 0.0f) ? -deltaX : deltaX;
-        const float absDY = (deltaY < 0.0f) ? -deltaY : deltaY;
-
-        const float overlapX = (pw * 0.5f + ow * 0.5f) - absDX;
-        const float overlapY = (ph * 0.5f + oh * 0.5f) - absDY;
-
-        if (overlapX < overlapY) {
-          const float push = (deltaX < 0.0f) ? -overlapX : overlapX;
-          pt.position.x += push;
-          playerRect.x += static_cast<int>(push);
-          // opzionale: pt.velocity.x = 0.0f;
-        } else {
-          const float push = (deltaY < 0.0f) ? -overlapY : overlapY;
-          pt.position.y += push;
-          playerRect.y += static_cast<int>(push);
-          // opzionale: pt.velocity.y = 0.0f;
-        }
-      }
+  // Agents steer toward the player's cell from the next tick on
+  playerField.SetGoal(eye.x, eye.y);
+  playerField.Update();
+
+  // What the player can see, traced against the map
+  if (showColliders) {
+    GridRaycast::CastFan(eye, 0.0f, 6.28318531f, sightDistance,
+                         sightHits.data(), sightHits.size());
+    for (const RayHit &hit : sightHits) {
+      DebugDraw::Line(static_cast<int>(eye.x), static_cast<int>(eye.y),
+                      static_cast<int>(hit.point.x),
+                      static_cast<int>(hit.point.y), debugRayColor);
     }
   }
 
@@ -195,29 +497,166 @@ void Game::update() {
   }
 }
 
+/**
+ * Test the player against every collider and emit a CollisionEvent per
+ * contact. Each push is applied to the tested rectangle before the next
+ * collider, as resolution does to the transform.
+ */
+void Game::detectCollisions() {
+  // Usa il collider del player SOLO se presente, altrimenti nessuna collisione
+  if (!player.hasComponent<ColliderComponent>()) {
+    return;
+  }
+
+  const auto &playerCollider = player.getComponent<ColliderComponent>();
+  const CollisionMask mask = Collision::Mask(playerCollider.layer);
+  SDL_Rect playerRect = playerCollider.collider;
+
+  // Pushes move the rectangle during the loop, by less than a cell: the
+  // candidates come from one cell further around it
+  const int cellSize = map->GetScaledSize();
+  const SDL_Rect area = {playerRect.x - cellSize, playerRect.y - cellSize,
+                         playerRect.w + 2 * cellSize,
+                         playerRect.h + 2 * cellSize};
+  colliderGrid.Query(area, candidates);
+
+  // Grid cells the player is tested in
+  if (showColliders) {
+    DebugDraw::Cells(area, cellSize, debugCellColor);
+  }
+
+  for (ColliderComponent *candidate : candidates) {
+    const auto &other = *candidate;
+    if (!other.entity->hasGroup(groupColliders)) {
+      continue; // The player's own collider, and any other non-terrain one
+    }
+
+    // Layers that do not collide with the player are rejected before any
+    // rectangle test
+    if ((mask & (CollisionMask{1} << other.layer)) == 0) {
+      continue;
+    }
+
+    const SDL_Rect cCol = other.collider;
+    if (!Collision::AABB(playerRect, cCol)) {
+      continue;
+    }
+
+    const float px = static_cast<float>(playerRect.x);
+    const float py = static_cast<float>(playerRect.y);
+    const float pw = static_cast<float>(playerRect.w);
+    const float ph = static_cast<float>(playerRect.h);
+
+    const float ox = static_cast<float>(cCol.x);
+    const float oy = static_cast<float>(cCol.y);
+    const float ow = static_cast<float>(cCol.w);
+    const float oh = static_cast<float>(cCol.h);
+
+    const float pCx = px + pw * 0.5f;
+    const float pCy = py + ph * 0.5f;
+    const float oCx = ox + ow * 0.5f;
+    const float oCy = oy + oh * 0.5f;
+
+    const float deltaX = pCx - oCx;
+    const float deltaY = pCy - oCy;
+
+    const float absDX = (deltaX < 0.0f) ? -deltaX : deltaX;
+    const float absDY = (deltaY < 0.0f) ? -deltaY : deltaY;
+
+    const float overlapX = (pw * 0.5f + ow * 0.5f) - absDX;
+    const float overlapY = (ph * 0.5f + oh * 0.5f) - absDY;
+
+    CollisionEvent contact = {&player, other.entity, {}, {}};
+    SDL_IntersectRect(&playerRect, &cCol, &contact.contact);
+
+    if (overlapX < overlapY) {
+      contact.push.x = (deltaX < 0.0f) ? -overlapX : overlapX;
+      playerRect.x += static_cast<int>(contact.push.x);
+    } else {
+      contact.push.y = (deltaY < 0.0f) ? -overlapY : overlapY;
+      playerRect.y += static_cast<int>(contact.push.y);
+    }
+
+    EventBus::Emit(contact);
+  }
+}
+
+/**
+ * Push entities out of what they collided with this tick
+ */
+void Game::resolveCollisions() {
+  for (const auto &contact : EventBus::Events<CollisionEvent>()) {
+    auto &transform = contact.entity->changeComponent<TransformComponent>();
+    // Exactly one axis is pushed
+    if (contact.push.x != 0.0f) {
+      transform.position.x += contact.push.x;
+    } else {
+      transform.position.y += contact.push.y;
+    }
+
+    if (showColliders) {
+      DebugDraw::FillRect(contact.contact, debugContactColor);
+    }
+  }
+}
+
 /**
  * Render the game
+ * Submits the commands of the last finished tick. All SDL renderer calls
+ * happen here, on the main thread.
  */
 void Game::render() {
+  AllocScope allocScope(AllocTag::Render);
+
+  const Uint64 renderStart = SDL_GetPerformanceCounter();
+  if (lastRenderStart != 0) {
+    hudStats.frameMs = Utility::MsBetween(lastRenderStart, renderStart);
+  }
+  lastRenderStart = renderStart;
+
+  // Upload textures decoded since the last frame, within a time budget
+  TextureManager::ProcessUploads(uploadBudgetMs);
+
+  // Cold-start measurement: time from init until every texture is on the GPU
+  if (!loadReported && TextureManager::IsIdle()) {
+    LOG_INFO("Assets ready in %.3f ms (%s)", Utility::MsSince(loadStart),
+             AssetPack::IsOpen() ? "pack" : "loose files");
+    loadReported = true;
+  }
+
   // Clear the renderer
   SDL_RenderClear(renderer);
 
-  for (auto &tile : tiles) {
-    tile->draw();
+  // The world goes into the low resolution target: the renderer scale
+  // shrinks every blit there, rather than each component
+  if (worldTarget) {
+    SDL_SetRenderTarget(renderer, worldTarget);
+    SDL_RenderClear(renderer);
+    const float scale = 1.0f / static_cast<float>(renderScale);
+    SDL_RenderSetScale(renderer, scale, scale);
   }
 
-  for (auto &player : players) {
-    player->draw();
-  }
+  renderQueue.flush();
+  ParticleSystem::Flush();
 
-  if (showColliders) {
-    for (auto &collider : colliders) {
-      collider->draw();
-    }
+  // One nearest-neighbour upscale; the overlays stay at window resolution
+  if (worldTarget) {
+    SDL_RenderSetScale(renderer, 1.0f, 1.0f);
+    SDL_SetRenderTarget(renderer, nullptr);
+    SDL_RenderCopy(renderer, worldTarget, nullptr, &upscaled);
+  }
 
-    if (player.hasComponent<ColliderComponent>()) {
-      player.getComponent<ColliderComponent>().draw();
-    }
+  DebugDraw::Flush();
+
+  // Recorded while hidden too, so the graph is full when it is shown
+  hudStats.renderMs = Utility::MsSince(renderStart);
+  hudStats.drawCalls = renderQueue.size() + ParticleSystem::DrawCalls() +
+                       DebugDraw::DrawCalls() + (worldTarget ? 1 : 0) +
+                       (showHud ? 1 : 0);
+  hudStats.textureBytes = TextureManager::TextureBytes();
+  DebugHud::Record(hudStats);
+  if (showHud) {
+    DebugHud::Flush();
   }
 
   // Present the renderer
@@ -228,6 +667,35 @@ void Game::render() {
  * Clean the game
  */
 void Game::clean() {
+  // Stop the simulation thread before tearing down SDL
+  if (simulationThread.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(simulationMutex);
+      stopSimulation = true;
+    }
+    simulationCv.notify_one();
+    simulationThread.join();
+  }
+
+  if (InputRecorder::IsReplaying()) {
+    LOG_INFO("Replay ended after %u ticks, state hash %016llx",
+             InputRecorder::Ticks(),
+             static_cast<unsigned long long>(stateHash()));
+  }
+  InputRecorder::Stop();
+
+  AllocTracker::Report();
+  manager.reportMemory();
+
+  BehaviourScheduler::Clear(); // Before the entities they run for
+  DebugHud::Clean();
+  if (worldTarget) {
+    SDL_DestroyTexture(worldTarget);
+    worldTarget = nullptr;
+  }
+  TextureManager::Clean();
+  AssetPack::Close(); // After the textures: pending surfaces may point into it
+
   // Destroy the renderer and window
   SDL_DestroyRenderer(renderer);
   SDL_DestroyWindow(window);
@@ -236,29 +704,77 @@ void Game::clean() {
   IMG_Quit();
   SDL_Quit();
 
-  Utility::Log("Game cleaned");
+  LOG_INFO("Game cleaned");
+  Logger::Shutdown();
 }
 
 /**
  * Handle events
  */
 void Game::handleEvents() {
+  AllocScope allocScope(AllocTag::Input);
+
+  Input::BeginFrame();
+
   while (SDL_PollEvent(&event)) {
-    switch (event.type) {
-    case SDL_QUIT:
+    if (event.type == SDL_QUIT) {
+      Input::Trigger(Action::Quit);
+    }
+    Input::HandleEvent(event);
+  }
+
+  InputFrame frame = Input::Sample();
+
+  if (InputRecorder::IsReplaying()) {
+    // The live input is ignored, except for closing the window
+    const bool quit = (frame.pressed & actionBit(Action::Quit)) != 0;
+    if (!InputRecorder::Next(frame)) {
       isRunning = false;
-      break;
-    case SDL_KEYDOWN:
-      if (event.key.repeat == 0) {
-        if (event.key.keysym.sym == SDLK_ESCAPE) {
-          isRunning = false;
-        } else if (event.key.keysym.sym == SDLK_F1) {
-          showColliders = !showColliders;
-        }
-      }
-      break;
-    default:
-      break;
+      return;
+    }
+    if (quit) {
+      frame.pressed |= actionBit(Action::Quit);
+    }
+  } else {
+    InputRecorder::Record(frame);
+  }
+
+  // The simulation thread is idle here: sync() has waited for it
+  Input::Update(frame);
+
+  const InputSnapshot &input = Input::Current();
+  if (input.wasPressed(Action::Quit)) {
+    isRunning = false;
+  }
+  if (input.wasPressed(Action::ToggleColliders)) {
+    showColliders = !showColliders;
+  }
+  if (input.wasPressed(Action::ToggleHud)) {
+    showHud = !showHud;
+  }
+}
+
+/**
+ * Hash the state a replay must reproduce: the camera and every player
+ * transform. Two runs of the same recording match only if they agree.
+ */
+std::uint64_t Game::stateHash() const {
+  // FNV-1a over the raw bytes
+  std::uint64_t hash = 14695981039346656037ull;
+  auto mix = [&hash](const void *data, std::size_t size) {
+    const auto *bytes = static_cast<const unsigned char *>(data);
+    for (std::size_t i = 0; i < size; i++) {
+      hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+  };
+
+  mix(&camera, sizeof(camera));
+  for (auto &entity : players) {
+    if (entity->hasComponent<TransformComponent>()) {
+      const auto &transform = entity->getComponent<TransformComponent>();
+      mix(&transform.position, sizeof(transform.position));
+      mix(&transform.velocity, sizeof(transform.velocity));
     }
   }
+  return hash;
 }
\ No newline at end of file
@@ -3,8 +3,16 @@
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <vector>
 
+#include "debugHud/debug_hud.hpp"
+#include "inputRecorder/input_recorder.hpp"
+#include "renderQueue/render_queue.hpp"
+#include "snapshot/snapshot.hpp"
+
 class ColliderComponent;
 
 /**
@@ -23,26 +31,65 @@ public:
             bool fullscreen);
 
   void handleEvents(); // Handle the events of the game
-  void update();       // Update the game
-  void render();       // Render the game
+  void update();       // Start simulating the next tick
+  void render();       // Render the last simulated tick
+  void sync();         // Wait for the tick and publish its render commands
   void clean();        // Clean the game
 
   bool running() { return isRunning; }
 
+  std::uint64_t stateHash() const; // Fingerprint of the simulated world
+
   static SDL_Renderer *renderer; // The renderer of the game
   static SDL_Event event;        // The event of the game
   static bool isRunning;
   static SDL_Rect camera;
   static bool showColliders; // Whether to show colliders
+  static bool showHud;       // Whether to show the performance HUD
+  static RenderQueue renderQueue; // Commands produced by the simulation
+  static bool headless; // Hidden window, no vsync: set before init()
+  // Window pixels per rendered world pixel: above 1 the world is drawn into
+  // a smaller target and upscaled once per frame. Set before init().
+  static int renderScale;
+  static int spawnAgents; // Agents spawned from a prefab by init()
 
-  enum groupLabels : std::size_t {
-    groupMap,
-    groupPlayers,
-    groupColliders,
+  // Drawn in this order; within a layer sprites are sorted by their feet
+  enum renderLayers : int {
+    layerMap,
+    layerPlayers,
   };
 
 private:
   SDL_Window *window; // The window of the game
+  SDL_Texture *worldTarget = nullptr; // Low resolution world, if renderScale > 1
+  SDL_Rect upscaled = {0, 0, 0, 0};   // Where the target lands in the window
+
+  Uint64 loadStart = 0;      // Performance counter at the start of init
+  bool loadReported = false; // Whether the load time has been logged
+
+  // Performance HUD figures. simulateMs is written by the simulation thread
+  // and read once sync() has waited for it.
+  HudStats hudStats;
+  Uint64 lastRenderStart = 0;
+  double simulateMs = 0.0;
+
+  // Simulation thread: runs simulate() while the main thread renders
+  std::thread simulationThread;
+  std::mutex simulationMutex;
+  std::condition_variable simulationCv;
+  bool tickRequested = false;
+  bool stopSimulation = false;
+
+  // World snapshots, simulation thread only
+  std::vector<std::uint8_t> snapshot;  // Taken at the end of every tick
+  std::vector<std::uint8_t> quickSave; // Restored by QuickLoad
+  SnapshotHistory history{600};        // Last ticks, for Rewind
+
+  void simulate(); // One tick of game logic, records render commands
+  void step();     // Advance the world by one tick
+  void detectCollisions();  // Emits a CollisionEvent per player contact
+  void resolveCollisions(); // Applies this tick's CollisionEvents
+  void simulationLoop();
 };
 
 #endif
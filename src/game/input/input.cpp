@@ -0,0 +1,142 @@
+#include "input.hpp"
+
+std::array<Input::Bindings, actionCount> Input::bindings = {};
+std::array<Input::AxisBinding, axisCount> Input::axisBindings = {};
+std::uint32_t Input::latched = 0;
+InputSnapshot Input::current;
+
+namespace {
+
+// Bindings are loaded on first use
+bool bindingsLoaded = false;
+
+} // namespace
+
+void Input::ResetBindings() {
+  bindingsLoaded = true; // Bind() below must not reload them
+
+  for (auto &binding : bindings) {
+    binding.count = 0;
+  }
+
+  Bind(Action::MoveUp, SDL_SCANCODE_UP);
+  Bind(Action::MoveUp, SDL_SCANCODE_W);
+  Bind(Action::MoveDown, SDL_SCANCODE_DOWN);
+  Bind(Action::MoveDown, SDL_SCANCODE_S);
+  Bind(Action::MoveLeft, SDL_SCANCODE_LEFT);
+  Bind(Action::MoveLeft, SDL_SCANCODE_A);
+  Bind(Action::MoveRight, SDL_SCANCODE_RIGHT);
+  Bind(Action::MoveRight, SDL_SCANCODE_D);
+  Bind(Action::Quit, SDL_SCANCODE_ESCAPE);
+  Bind(Action::ToggleColliders, SDL_SCANCODE_F1);
+  Bind(Action::QuickSave, SDL_SCANCODE_F5);
+  Bind(Action::QuickLoad, SDL_SCANCODE_F9);
+  Bind(Action::Rewind, SDL_SCANCODE_BACKSPACE);
+  Bind(Action::ToggleHud, SDL_SCANCODE_F3);
+
+  axisBindings[static_cast<std::size_t>(Axis::MoveX)] = {Action::MoveLeft,
+                                                         Action::MoveRight};
+  axisBindings[static_cast<std::size_t>(Axis::MoveY)] = {Action::MoveUp,
+                                                         Action::MoveDown};
+}
+
+/**
+ * Add a key to an action
+ * @return false if the action already has maxBindingsPerAction keys
+ */
+bool Input::Bind(Action action, SDL_Scancode scancode) {
+  if (!bindingsLoaded) {
+    ResetBindings();
+  }
+
+  Bindings &binding = bindings[static_cast<std::size_t>(action)];
+  if (binding.count == maxBindingsPerAction) {
+    return false;
+  }
+  binding.keys[binding.count++] = scancode;
+  return true;
+}
+
+void Input::Unbind(Action action) {
+  if (!bindingsLoaded) {
+    ResetBindings();
+  }
+  bindings[static_cast<std::size_t>(action)].count = 0;
+}
+
+/**
+ * Drive an axis from two actions: -1 while negative is held, +1 while
+ * positive is held, 0 for both or neither
+ */
+void Input::BindAxis(Axis axis, Action negative, Action positive) {
+  if (!bindingsLoaded) {
+    ResetBindings();
+  }
+  axisBindings[static_cast<std::size_t>(axis)] = {negative, positive};
+}
+
+void Input::BeginFrame() {
+  if (!bindingsLoaded) {
+    ResetBindings();
+  }
+  latched = 0;
+}
+
+/**
+ * Latch key presses, so a tap shorter than a tick is still seen
+ */
+void Input::HandleEvent(const SDL_Event &event) {
+  if (event.type != SDL_KEYDOWN || event.key.repeat != 0) {
+    return;
+  }
+
+  const SDL_Scancode scancode = event.key.keysym.scancode;
+  for (std::size_t a = 0; a < actionCount; a++) {
+    const Bindings &binding = bindings[a];
+    for (std::size_t k = 0; k < binding.count; k++) {
+      if (binding.keys[k] == scancode) {
+        latched |= 1u << a;
+      }
+    }
+  }
+}
+
+void Input::Trigger(Action action) { latched |= actionBit(action); }
+
+/**
+ * Read the keyboard once and map it to actions
+ */
+InputFrame Input::Sample() {
+  const Uint8 *state = SDL_GetKeyboardState(nullptr);
+
+  InputFrame frame;
+  for (std::size_t a = 0; a < actionCount; a++) {
+    const Bindings &binding = bindings[a];
+    for (std::size_t k = 0; k < binding.count; k++) {
+      if (state[binding.keys[k]]) {
+        frame.held |= 1u << a;
+        break;
+      }
+    }
+  }
+  frame.pressed = latched;
+  return frame;
+}
+
+/**
+ * Derive the edges and axes of a new tick from its frame and the previous
+ * snapshot. Must not run while the simulation reads the snapshot.
+ */
+void Input::Update(const InputFrame &frame) {
+  const std::uint32_t previous = current.held;
+
+  current.held = frame.held;
+  current.pressed = frame.pressed | (frame.held & ~previous);
+  current.released = previous & ~frame.held;
+
+  for (std::size_t i = 0; i < axisCount; i++) {
+    const AxisBinding &axis = axisBindings[i];
+    current.axes[i] = static_cast<float>(current.isHeld(axis.positive)) -
+                      static_cast<float>(current.isHeld(axis.negative));
+  }
+}
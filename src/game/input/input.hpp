@@ -0,0 +1,122 @@
+#ifndef INPUT_HPP
+#define INPUT_HPP
+
+#include <SDL2/SDL.h>
+#include <array>
+#include <cstdint>
+
+// Everything the player can ask for, independent of the keys bound to it
+enum class Action : std::uint8_t {
+  MoveUp,
+  MoveDown,
+  MoveLeft,
+  MoveRight,
+  Quit,
+  ToggleColliders,
+  QuickSave,
+  QuickLoad,
+  Rewind,
+  ToggleHud,
+  Count,
+};
+
+enum class Axis : std::uint8_t {
+  MoveX,
+  MoveY,
+  Count,
+};
+
+constexpr std::size_t actionCount = static_cast<std::size_t>(Action::Count);
+constexpr std::size_t axisCount = static_cast<std::size_t>(Axis::Count);
+constexpr std::size_t maxBindingsPerAction = 4;
+
+static_assert(actionCount <= 32, "Action bits must fit in 32 bits");
+
+constexpr std::uint32_t actionBit(Action action) {
+  return 1u << static_cast<std::uint32_t>(action);
+}
+
+/**
+ * Raw input of one tick, as sampled or recorded: one bit per action.
+ * pressed also holds keys pressed and released within the same tick, which
+ * sampling the held state alone would miss.
+ */
+struct InputFrame {
+  std::uint32_t held = 0;
+  std::uint32_t pressed = 0;
+
+  bool operator==(const InputFrame &other) const {
+    return held == other.held && pressed == other.pressed;
+  }
+  bool operator!=(const InputFrame &other) const { return !(*this == other); }
+};
+
+/**
+ * Action and axis states of one tick. Built once per tick by Input::Update
+ * and read-only afterwards, so any number of entities can query it.
+ */
+class InputSnapshot {
+public:
+  bool isHeld(Action action) const { return (held & actionBit(action)) != 0; }
+  bool wasPressed(Action action) const {
+    return (pressed & actionBit(action)) != 0;
+  }
+  bool wasReleased(Action action) const {
+    return (released & actionBit(action)) != 0;
+  }
+  float axis(Axis axis) const { return axes[static_cast<std::size_t>(axis)]; }
+
+private:
+  friend class Input;
+
+  std::uint32_t held = 0;
+  std::uint32_t pressed = 0;  // Went down this tick
+  std::uint32_t released = 0; // Went up this tick
+  std::array<float, axisCount> axes{};
+};
+
+/**
+ * Input class
+ *
+ * Samples the keyboard once per tick on the main thread and maps it to
+ * actions through rebindable key bindings. Controllers only read the
+ * resulting InputSnapshot: input costs the same however many entities are
+ * controlled.
+ *
+ * @author: @iMeyu
+ */
+class Input {
+public:
+  static void ResetBindings(); // Restore the default key bindings
+  static bool Bind(Action action, SDL_Scancode scancode);
+  static void Unbind(Action action);
+  static void BindAxis(Axis axis, Action negative, Action positive);
+
+  // Sampling, main thread only: BeginFrame, then feed every polled event,
+  // then Sample
+  static void BeginFrame();
+  static void HandleEvent(const SDL_Event &event);
+  static void Trigger(Action action); // Press an action without a key
+  static InputFrame Sample();
+
+  static void Update(const InputFrame &frame); // Publish the next snapshot
+  static const InputSnapshot &Current() { return current; }
+
+private:
+  struct AxisBinding {
+    Action negative;
+    Action positive;
+  };
+
+  struct Bindings {
+    std::array<SDL_Scancode, maxBindingsPerAction> keys;
+    std::size_t count = 0;
+  };
+
+  static std::array<Bindings, actionCount> bindings;
+  static std::array<AxisBinding, axisCount> axisBindings;
+  static std::uint32_t latched; // Actions pressed since BeginFrame
+  static InputSnapshot current;
+};
+
+#endif
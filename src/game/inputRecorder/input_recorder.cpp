@@ -0,0 +1,187 @@
+#include "input_recorder.hpp"
+#include "../../utility/logger/logger.hpp"
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+// [RecordingHeader][RecordedRun x runCount]
+constexpr char recordingMagic[4] = {'G', 'R', 'E', 'C'};
+constexpr std::uint32_t recordingVersion = 2;
+
+struct RecordingHeader {
+  char magic[4];
+  std::uint32_t version;
+  std::uint32_t tickCount;
+  std::uint32_t runCount;
+};
+
+struct RecordedRun {
+  std::uint32_t held;
+  std::uint32_t pressed;
+  std::uint32_t length; // Consecutive ticks with this frame
+};
+
+static_assert(sizeof(RecordingHeader) == 16, "Recording header layout");
+static_assert(sizeof(RecordedRun) == 12, "Recorded run layout");
+
+// Runs reserved when recording starts, so a session changes its input this
+// many times before the log grows during a frame
+constexpr std::size_t reservedRuns = 1 << 16;
+
+} // namespace
+
+InputRecorder::Mode InputRecorder::mode = InputRecorder::Mode::Off;
+const char *InputRecorder::outputPath = nullptr;
+std::vector<InputRecorder::Run> InputRecorder::runs;
+std::size_t InputRecorder::runIndex = 0;
+std::uint32_t InputRecorder::runTick = 0;
+std::uint32_t InputRecorder::tick = 0;
+
+/**
+ * Start recording the input of every tick
+ * @param path The file written by Stop()
+ */
+bool InputRecorder::StartRecording(const char *path) {
+  Stop();
+
+  // Fail now rather than after a long session
+  std::ofstream probe(path, std::ios::binary | std::ios::trunc);
+  if (!probe) {
+    LOG_ERROR("Cannot write input recording %s", path);
+    return false;
+  }
+
+  runs.reserve(reservedRuns);
+  outputPath = path;
+  mode = Mode::Record;
+  return true;
+}
+
+/**
+ * Load a recording and play it back in place of the live input
+ */
+bool InputRecorder::StartReplay(const char *path) {
+  Stop();
+
+  std::ifstream file(path, std::ios::binary);
+  RecordingHeader header;
+  if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+      std::memcmp(header.magic, recordingMagic, sizeof(recordingMagic)) != 0 ||
+      header.version != recordingVersion) {
+    LOG_ERROR("Invalid input recording %s", path);
+    return false;
+  }
+
+  // The header is not trusted with the size of the run table
+  const std::streamoff start = file.tellg();
+  file.seekg(0, std::ios::end);
+  const std::streamoff remaining = file.tellg() - start;
+  file.seekg(start);
+  const std::uint64_t tableSize =
+      std::uint64_t{header.runCount} * sizeof(RecordedRun);
+  if (remaining < 0 || static_cast<std::uint64_t>(remaining) < tableSize) {
+    LOG_ERROR("Truncated input recording %s", path);
+    return false;
+  }
+
+  runs.reserve(header.runCount);
+  for (std::uint32_t i = 0; i < header.runCount; i++) {
+    RecordedRun recorded;
+    if (!file.read(reinterpret_cast<char *>(&recorded), sizeof(recorded))) {
+      LOG_ERROR("Truncated input recording %s", path);
+      runs.clear();
+      return false;
+    }
+
+    Run run;
+    run.frame.held = recorded.held;
+    run.frame.pressed = recorded.pressed;
+    run.length = recorded.length;
+    runs.push_back(run);
+  }
+
+  LOG_INFO("Replaying %u ticks from %s", header.tickCount, path);
+  mode = Mode::Replay;
+  return true;
+}
+
+void InputRecorder::Stop() {
+  if (mode == Mode::Record) {
+    std::ofstream file(outputPath, std::ios::binary | std::ios::trunc);
+
+    RecordingHeader header;
+    std::memcpy(header.magic, recordingMagic, sizeof(recordingMagic));
+    header.version = recordingVersion;
+    header.tickCount = tick;
+    header.runCount = static_cast<std::uint32_t>(runs.size());
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    for (const Run &run : runs) {
+      RecordedRun recorded = {run.frame.held, run.frame.pressed, run.length};
+      file.write(reinterpret_cast<const char *>(&recorded), sizeof(recorded));
+    }
+
+    if (file) {
+      LOG_INFO("Recorded %u ticks to %s (%zu bytes)", tick, outputPath,
+               sizeof(header) + runs.size() * sizeof(RecordedRun));
+    } else {
+      LOG_ERROR("Failed to write input recording %s", outputPath);
+    }
+  }
+
+  mode = Mode::Off;
+  outputPath = nullptr;
+  runs.clear();
+  runIndex = 0;
+  runTick = 0;
+  tick = 0;
+}
+
+/**
+ * Append the input of the current tick
+ */
+void InputRecorder::Record(const InputFrame &frame) {
+  if (mode != Mode::Record) {
+    return;
+  }
+
+  if (!runs.empty() && runs.back().frame == frame) {
+    runs.back().length++;
+  } else {
+    runs.push_back({frame, 1});
+  }
+  tick++;
+}
+
+/**
+ * Get the input of the next recorded tick
+ * @param frame Receives the recorded input
+ * @return false when every recorded tick has been played
+ */
+bool InputRecorder::Next(InputFrame &frame) {
+  if (mode != Mode::Replay) {
+    return false;
+  }
+
+  while (runIndex < runs.size() && runTick >= runs[runIndex].length) {
+    runIndex++;
+    runTick = 0;
+  }
+  if (runIndex == runs.size()) {
+    return false;
+  }
+
+  frame = runs[runIndex].frame;
+  runTick++;
+  tick++;
+  return true;
+}
+
+std::uint32_t InputRecorder::Length() {
+  std::uint32_t length = 0;
+  for (const Run &run : runs) {
+    length += run.length;
+  }
+  return length;
+}
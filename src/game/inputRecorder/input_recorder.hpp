@@ -0,0 +1,53 @@
+#ifndef INPUT_RECORDER_HPP
+#define INPUT_RECORDER_HPP
+
+#include "../input/input.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * InputRecorder class
+ *
+ * Records the InputFrame of every tick to a binary log, or plays a log back
+ * in place of the live input. The simulation depends on nothing else that
+ * varies between runs, so a replay reproduces the recorded session tick for
+ * tick and can be used to compare builds.
+ *
+ * Frames hold actions, not keys, so a recording survives rebinding. They
+ * are stored run-length encoded: held actions rarely change between ticks,
+ * so a long session stays a few kilobytes.
+ *
+ * @author: @iMeyu
+ */
+class InputRecorder {
+public:
+  static bool StartRecording(const char *path);
+  static bool StartReplay(const char *path);
+  static void Stop(); // Write the log when recording
+
+  static bool IsRecording() { return mode == Mode::Record; }
+  static bool IsReplaying() { return mode == Mode::Replay; }
+
+  static void Record(const InputFrame &frame);
+  static bool Next(InputFrame &frame); // false once the replay is over
+
+  static std::uint32_t Ticks() { return tick; } // Recorded or replayed so far
+  static std::uint32_t Length(); // Ticks in the log
+
+private:
+  enum class Mode { Off, Record, Replay };
+
+  struct Run {
+    InputFrame frame;
+    std::uint32_t length;
+  };
+
+  static Mode mode;
+  static const char *outputPath;
+  static std::vector<Run> runs;
+  static std::size_t runIndex;  // Replay position
+  static std::uint32_t runTick; // Ticks consumed from runs[runIndex]
+  static std::uint32_t tick;
+};
+
+#endif
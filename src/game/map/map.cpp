@@ -1,6 +1,9 @@
 #include "map.hpp"
 #include "../game.hpp"
+#include "../../assetPack/asset_pack.hpp"
+#include "../../utility/logger/logger.hpp"
 #include <fstream>
+#include <sstream>
 #include <cstdlib>
 #include "../ECS/ECS.hpp"
 #include "../components/tileComponent/tile_component.hpp"
@@ -14,30 +17,47 @@ Map::~Map() {}
 
 /**
  * Load the map
+ * The cooked asset pack is used when it contains the map, the loose file
+ * otherwise.
  */
 void Map::LoadMap(std::string path, int sizeX, int sizeY) {
-  char tile;
+  std::string cooked;
+  if (AssetPack::LoadText(path, cooked)) {
+    std::istringstream mapStream(cooked);
+    ParseMap(mapStream, sizeX, sizeY);
+    return;
+  }
+
   std::fstream mapFile;
   mapFile.open(path);
   if (!mapFile.is_open()) {
-    Utility::Log("Failed to open map file: " + path);
+    LOG_ERROR("Failed to open map file: %s", path.c_str());
     return;
   }
 
+  ParseMap(mapFile, sizeX, sizeY);
+  mapFile.close();
+}
+
+/**
+ * Build tiles and colliders from the map layers
+ */
+void Map::ParseMap(std::istream &mapFile, int sizeX, int sizeY) {
+  char tile;
   int srcX, srcY;
 
   for (int y = 0; y < sizeY; y++) {
     for (int x = 0; x < sizeX; x++) {
       mapFile.get(tile);
       if (!std::isdigit(static_cast<unsigned char>(tile))) {
-        Utility::Log("Invalid Y tile char in map file");
+        LOG_ERROR("Invalid Y tile char in map file");
         return;
       }
       srcY = (tile - '0') * mapTileSize;
 
       mapFile.get(tile);
       if (!std::isdigit(static_cast<unsigned char>(tile))) {
-        Utility::Log("Invalid X tile char in map file");
+        LOG_ERROR("Invalid X tile char in map file");
         return;
       }
       srcX = (tile - '0') * mapTileSize;
@@ -49,19 +69,30 @@ void Map::LoadMap(std::string path, int sizeX, int sizeY) {
 
   mapFile.ignore(); // Ignore the newline character after the last row
 
+  width = sizeX;
+  height = sizeY;
+  solid.assign(static_cast<std::size_t>(sizeX) * sizeY, 0);
+
   for(int y = 0; y < sizeY; y++ ) {
     for(int x = 0; x < sizeX; x++) {
       mapFile.get(tile);
       if(tile == '1') {
+        solid[static_cast<std::size_t>(y) * sizeX + x] = 1;
         auto &collider(manager.addEntity());
         collider.addComponent<ColliderComponent>("terrain", x * scaledSize, y * scaledSize, scaledSize);
-        collider.addGroup(Game::groupColliders);
+        collider.addGroup(groupColliders);
+        collider.setActivity(Activity::Static);
       }
       mapFile.ignore();
     }
   }
+}
 
-  mapFile.close();
+bool Map::IsSolid(int cellX, int cellY) const {
+  if (cellX < 0 || cellY < 0 || cellX >= width || cellY >= height) {
+    return true;
+  }
+  return solid[static_cast<std::size_t>(cellY) * width + cellX] != 0;
 }
 
 void Map::AddTile(int srcX, int srcY, int xpos, int ypos) {
@@ -69,5 +100,6 @@ void Map::AddTile(int srcX, int srcY, int xpos, int ypos) {
 
   auto &tile(manager.addEntity());
   tile.addComponent<TileComponent>(srcX, srcY, xpos, ypos, mapTileSize, mapScale, mapFilePath);
-  tile.addGroup(Game::groupMap);
+  tile.addGroup(groupMap);
+  tile.setActivity(Activity::Static);
 }
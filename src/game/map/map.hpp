@@ -2,7 +2,10 @@
 #define MAP_HPP
 
 #include <SDL2/SDL.h>
+#include <cstdint>
+#include <istream>
 #include <string>
+#include <vector>
 
 /**
  * Map class
@@ -19,11 +22,25 @@ public:
   void AddTile(int srcX, int srcY, int xpos, int ypos);
   void LoadMap(std::string path, int sizeX, int sizeY);
 
+  int GetScaledSize() const { return scaledSize; } // Size of a cell in pixels
+
+  // Collision layer as a grid of cells, row major, 1 for solid
+  const std::vector<std::uint8_t> &GetSolid() const { return solid; }
+  int GetWidth() const { return width; }   // In cells
+  int GetHeight() const { return height; } // In cells
+  bool IsSolid(int cellX, int cellY) const; // Outside the map is solid
+
 private:
+  void ParseMap(std::istream &mapFile, int sizeX, int sizeY);
+
   const char *mapFilePath;
   int mapScale;
   int mapTileSize;
   int scaledSize;
+
+  std::vector<std::uint8_t> solid;
+  int width = 0;
+  int height = 0;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "movement_system.hpp"
+#include "../components/transformComponent/transform_component.hpp"
+#include "../vector2d/vector_batch.hpp"
+#include <algorithm>
+
+std::vector<TransformComponent *> MovementSystem::active;
+std::vector<float> MovementSystem::xs;
+std::vector<float> MovementSystem::ys;
+std::vector<float> MovementSystem::vxs;
+std::vector<float> MovementSystem::vys;
+std::vector<float> MovementSystem::speeds;
+
+/**
+ * Registered transforms.
+ * Never destroyed: components of global entities unregister during static
+ * destruction, possibly after this translation unit's statics are gone.
+ */
+std::vector<TransformComponent *> &MovementSystem::registry() {
+  static auto *transforms = new std::vector<TransformComponent *>();
+  return *transforms;
+}
+
+void MovementSystem::Register(TransformComponent *transform) {
+  auto &transforms = registry();
+  transform->movementSlot = transforms.size();
+  transforms.push_back(transform);
+}
+
+void MovementSystem::Unregister(TransformComponent *transform) {
+  auto &transforms = registry();
+  const std::size_t slot = transform->movementSlot;
+  // A prefab copy carries the slot of its prototype until it registers
+  if (slot < transforms.size() && transforms[slot] == transform) {
+    // Order does not matter: swap with the last one and pop
+    transforms[slot] = transforms.back();
+    transforms[slot]->movementSlot = slot;
+    transforms.pop_back();
+    transform->movementSlot = static_cast<std::size_t>(-1);
+  }
+}
+
+void MovementSystem::Update() {
+  active.clear();
+  xs.clear();
+  ys.clear();
+  vxs.clear();
+  vys.clear();
+  speeds.clear();
+
+  // Room for every registered transform, so the arrays grow when entities
+  // are spawned rather than when more of them start moving
+  const std::size_t registered = registry().size();
+  if (active.capacity() < registered) {
+    active.reserve(registered);
+    xs.reserve(registered);
+    ys.reserve(registered);
+    vxs.reserve(registered);
+    vys.reserve(registered);
+    speeds.reserve(registered);
+  }
+
+  // Gather the moving transforms of the entities updated this tick; a
+  // reduced-rate one moves as far as it would have in all its ticks
+  for (TransformComponent *t : registry()) {
+    if ((t->velocity.x == 0.0f && t->velocity.y == 0.0f) ||
+        !t->entity->updatesThisTick()) {
+      continue;
+    }
+    active.push_back(t);
+    xs.push_back(t->position.x);
+    ys.push_back(t->position.y);
+    vxs.push_back(t->velocity.x);
+    vys.push_back(t->velocity.y);
+    speeds.push_back(
+        static_cast<float>(t->speed * t->entity->ticksPerUpdate()));
+  }
+
+  VectorBatch::Integrate(xs.data(), ys.data(), vxs.data(), vys.data(),
+                         speeds.data(), active.size());
+
+  // Scatter the new positions back
+  for (std::size_t i = 0; i < active.size(); i++) {
+    active[i]->position.x = xs[i];
+    active[i]->position.y = ys[i];
+    active[i]->entity->markChanged<TransformComponent>();
+  }
+}
@@ -0,0 +1,39 @@
+#ifndef MOVEMENT_SYSTEM_HPP
+#define MOVEMENT_SYSTEM_HPP
+
+#include <cstddef>
+#include <vector>
+
+class TransformComponent;
+
+/**
+ * MovementSystem class
+ *
+ * Integrates every TransformComponent in one pass per tick instead of one
+ * virtual update per entity. Transforms with zero velocity are skipped: the
+ * moving ones are compacted into SoA arrays and advanced with
+ * VectorBatch::Integrate, then written back. Entities that do not update
+ * this tick (see Activity) do not move either.
+ *
+ * Transforms register themselves on init and unregister on destruction.
+ *
+ * @author: @iMeyu
+ */
+class MovementSystem {
+public:
+  static void Register(TransformComponent *transform);
+  static void Unregister(TransformComponent *transform);
+
+  static void Update(); // Advance every moving transform by one tick
+
+  static std::size_t ActiveCount() { return active.size(); }
+
+private:
+  static std::vector<TransformComponent *> &registry();
+
+  // Compacted moving transforms of the current tick, in SoA form
+  static std::vector<TransformComponent *> active;
+  static std::vector<float> xs, ys, vxs, vys, speeds;
+};
+
+#endif
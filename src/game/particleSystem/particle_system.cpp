@@ -0,0 +1,201 @@
+#include "particle_system.hpp"
+#include "../game.hpp"
+#include "../vector2d/vector_batch.hpp"
+#include <algorithm>
+
+std::vector<ParticleSystem::ParticlePool> ParticleSystem::pools;
+std::array<std::vector<ParticleSystem::Batch>, 2> ParticleSystem::batches;
+int ParticleSystem::back = 0;
+std::vector<int> ParticleSystem::indices;
+std::size_t ParticleSystem::drawCalls = 0;
+
+namespace {
+
+Uint8 toChannel(float value) {
+  return static_cast<Uint8>(std::min(std::max(value, 0.0f), 255.0f));
+}
+
+} // namespace
+
+void ParticleSystem::ParticlePool::resize(std::size_t capacity) {
+  for (auto *attribute : {&x, &y, &vx, &vy, &life, &size, &r, &g, &b, &a,
+                          &dr, &dg, &db, &da}) {
+    attribute->resize(capacity);
+  }
+}
+
+void ParticleSystem::ParticlePool::kill(std::size_t i) {
+  const std::size_t last = --count;
+  for (auto *attribute : {&x, &y, &vx, &vy, &life, &size, &r, &g, &b, &a,
+                          &dr, &dg, &db, &da}) {
+    (*attribute)[i] = (*attribute)[last];
+  }
+}
+
+std::size_t ParticleSystem::Pool(TextureHandle texture) {
+  for (std::size_t i = 0; i < pools.size(); i++) {
+    if (pools[i].texture == texture) {
+      return i;
+    }
+  }
+
+  pools.emplace_back();
+  pools.back().texture = texture;
+  return pools.size() - 1;
+}
+
+void ParticleSystem::SetGravity(std::size_t pool, float pixelsPerSecond2) {
+  pools[pool].gravity = pixelsPerSecond2;
+}
+
+void ParticleSystem::Spawn(std::size_t pool, const ParticleSpawn &spawn) {
+  ParticlePool &p = pools[pool];
+  if (p.count == maxParticlesPerPool) {
+    return;
+  }
+
+  // Grow geometrically: spawning must not reallocate every tick
+  if (p.count == p.x.size()) {
+    p.resize(std::min(std::max<std::size_t>(p.count * 2, 1024),
+                      maxParticlesPerPool));
+  }
+
+  const std::size_t i = p.count++;
+  const float lifetime = std::max(spawn.lifetime, particleTickSeconds);
+  p.x[i] = spawn.x;
+  p.y[i] = spawn.y;
+  p.vx[i] = spawn.vx;
+  p.vy[i] = spawn.vy;
+  p.life[i] = lifetime;
+  p.size[i] = spawn.size;
+  p.r[i] = spawn.startColor.r;
+  p.g[i] = spawn.startColor.g;
+  p.b[i] = spawn.startColor.b;
+  p.a[i] = spawn.startColor.a;
+  p.dr[i] = (spawn.endColor.r - p.r[i]) / lifetime;
+  p.dg[i] = (spawn.endColor.g - p.g[i]) / lifetime;
+  p.db[i] = (spawn.endColor.b - p.b[i]) / lifetime;
+  p.da[i] = (spawn.endColor.a - p.a[i]) / lifetime;
+}
+
+/**
+ * Advance every pool by one tick, drop dead particles and record the
+ * vertices of the visible ones
+ */
+void ParticleSystem::Update(const SDL_Rect &camera) {
+  auto &out = batches[back];
+  out.resize(pools.size());
+
+  for (std::size_t i = 0; i < pools.size(); i++) {
+    integrate(pools[i]);
+    buildBatch(pools[i], camera, out[i]);
+  }
+}
+
+void ParticleSystem::integrate(ParticlePool &p) {
+  const float dt = particleTickSeconds;
+  const std::size_t n = p.count;
+
+  VectorBatch::MulAdd(p.x.data(), p.vx.data(), dt, n);
+  VectorBatch::MulAdd(p.y.data(), p.vy.data(), dt, n);
+  if (p.gravity != 0.0f) {
+    VectorBatch::Offset(p.vy.data(), p.gravity * dt, n);
+  }
+  VectorBatch::Offset(p.life.data(), -dt, n);
+  VectorBatch::MulAdd(p.r.data(), p.dr.data(), dt, n);
+  VectorBatch::MulAdd(p.g.data(), p.dg.data(), dt, n);
+  VectorBatch::MulAdd(p.b.data(), p.db.data(), dt, n);
+  VectorBatch::MulAdd(p.a.data(), p.da.data(), dt, n);
+
+  // Swap and pop: the particle moved into i is checked next
+  std::size_t i = 0;
+  while (i < p.count) {
+    if (p.life[i] <= 0.0f) {
+      p.kill(i);
+    } else {
+      i++;
+    }
+  }
+}
+
+void ParticleSystem::buildBatch(const ParticlePool &p, const SDL_Rect &camera,
+                                Batch &batch) {
+  batch.texture = p.texture;
+
+  // The buffer only grows, so steady state neither allocates nor clears it
+  if (batch.vertices.size() < p.count * 4) {
+    batch.vertices.resize(p.count * 4);
+  }
+  SDL_Vertex *out = batch.vertices.data();
+
+  const float left = static_cast<float>(camera.x);
+  const float top = static_cast<float>(camera.y);
+  const float right = left + static_cast<float>(camera.w);
+  const float bottom = top + static_cast<float>(camera.h);
+
+  for (std::size_t i = 0; i < p.count; i++) {
+    const float half = p.size[i] * 0.5f;
+    if (p.x[i] + half < left || p.x[i] - half > right ||
+        p.y[i] + half < top || p.y[i] - half > bottom) {
+      continue;
+    }
+
+    const float x0 = p.x[i] - half - left;
+    const float y0 = p.y[i] - half - top;
+    const float x1 = x0 + p.size[i];
+    const float y1 = y0 + p.size[i];
+    const SDL_Color color = {toChannel(p.r[i]), toChannel(p.g[i]),
+                             toChannel(p.b[i]), toChannel(p.a[i])};
+
+    out[0] = {{x0, y0}, color, {0.0f, 0.0f}};
+    out[1] = {{x1, y0}, color, {1.0f, 0.0f}};
+    out[2] = {{x1, y1}, color, {1.0f, 1.0f}};
+    out[3] = {{x0, y1}, color, {0.0f, 1.0f}};
+    out += 4;
+  }
+
+  batch.vertexCount = static_cast<std::size_t>(out - batch.vertices.data());
+}
+
+void ParticleSystem::Swap() { back = 1 - back; }
+
+/**
+ * Draw the visible particles of each pool with a single call
+ */
+void ParticleSystem::Flush() {
+  drawCalls = 0;
+  for (const Batch &batch : batches[1 - back]) {
+    const std::size_t quads = batch.vertexCount / 4;
+    if (quads == 0) {
+      continue;
+    }
+
+    // Shared by every batch; only grows
+    for (std::size_t q = indices.size() / 6; q < quads; q++) {
+      const int v = static_cast<int>(q * 4);
+      indices.insert(indices.end(), {v, v + 1, v + 2, v + 2, v + 3, v});
+    }
+
+    SDL_RenderGeometry(Game::renderer, TextureManager::Get(batch.texture),
+                       batch.vertices.data(),
+                       static_cast<int>(batch.vertexCount), indices.data(),
+                       static_cast<int>(quads * 6));
+    drawCalls++;
+  }
+}
+
+void ParticleSystem::Clear() {
+  for (ParticlePool &pool : pools) {
+    pool.count = 0;
+  }
+}
+
+std::size_t ParticleSystem::DrawCalls() { return drawCalls; }
+
+std::size_t ParticleSystem::LiveCount() {
+  std::size_t count = 0;
+  for (const ParticlePool &pool : pools) {
+    count += pool.count;
+  }
+  return count;
+}
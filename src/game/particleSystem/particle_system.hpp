@@ -0,0 +1,91 @@
+#ifndef PARTICLE_SYSTEM_HPP
+#define PARTICLE_SYSTEM_HPP
+
+#include "../../textureManager/texture_manager.hpp"
+#include <SDL2/SDL.h>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// Simulated time of one tick: the game ticks once per frame at 60 FPS
+constexpr float particleTickSeconds = 1.0f / 60.0f;
+
+// Live particles a pool can hold; spawns beyond it are dropped
+constexpr std::size_t maxParticlesPerPool = 256 * 1024;
+
+/**
+ * Initial state of one particle
+ */
+struct ParticleSpawn {
+  float x, y;   // World position
+  float vx, vy; // Pixels per second
+  float lifetime; // Seconds
+  float size;     // Pixels
+  SDL_Color startColor;
+  SDL_Color endColor; // Reached when the lifetime runs out
+};
+
+/**
+ * ParticleSystem class
+ *
+ * Particles live outside the ECS, in one pool per texture. A pool stores
+ * every attribute in its own array (structure of arrays), so a tick advances
+ * position, velocity, lifetime and colour with the VectorBatch kernels, one
+ * pass per attribute. A dead particle is replaced by the last one (swap and
+ * pop), keeping the arrays dense.
+ *
+ * Each pool is drawn with one SDL_RenderGeometry call. Like DebugDraw the
+ * vertices are double buffered: Update() runs on the simulation thread,
+ * Flush() on the render stage and Swap() in between.
+ *
+ * @author: @iMeyu
+ */
+class ParticleSystem {
+public:
+  // Pool drawing with texture, created on first use
+  static std::size_t Pool(TextureHandle texture);
+  static void SetGravity(std::size_t pool, float pixelsPerSecond2);
+
+  static void Spawn(std::size_t pool, const ParticleSpawn &spawn);
+
+  static void Update(const SDL_Rect &camera); // Advance one tick
+  static void Swap();
+  static void Flush(); // Main thread only
+
+  static void Clear(); // Kill every particle
+  static std::size_t LiveCount();
+  static std::size_t DrawCalls(); // SDL calls issued by the last Flush()
+
+private:
+  struct ParticlePool {
+    TextureHandle texture = 0;
+    float gravity = 0.0f;
+    std::size_t count = 0;
+
+    std::vector<float> x, y, vx, vy, life, size;
+    std::vector<float> r, g, b, a;     // Colour, 0 to 255
+    std::vector<float> dr, dg, db, da; // Colour change per second
+
+    void resize(std::size_t capacity);
+    void kill(std::size_t i); // Swap with the last live particle
+  };
+
+  // Vertices of one pool, in screen space
+  struct Batch {
+    TextureHandle texture = 0;
+    std::vector<SDL_Vertex> vertices; // Grown to the largest tick so far
+    std::size_t vertexCount = 0;
+  };
+
+  static void integrate(ParticlePool &pool);
+  static void buildBatch(const ParticlePool &pool, const SDL_Rect &camera,
+                         Batch &batch);
+
+  static std::vector<ParticlePool> pools;
+  static std::array<std::vector<Batch>, 2> batches;
+  static int back; // Index of the batches Update() writes
+  static std::vector<int> indices; // Two triangles per quad, main thread
+  static std::size_t drawCalls;
+};
+
+#endif
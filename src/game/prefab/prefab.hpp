@@ -0,0 +1,155 @@
+#ifndef PREFAB_HPP
+#define PREFAB_HPP
+
+#include "../ECS/ECS.hpp"
+#include "../components/components.hpp"
+#include <memory>
+#include <tuple>
+
+template <typename List> struct PrototypesOf;
+
+template <typename... Ts> struct PrototypesOf<TypeList<Ts...>> {
+  using type = std::tuple<std::unique_ptr<Ts>...>;
+};
+
+/**
+ * Prefab class
+ *
+ * A template for entities: a prototype of each of its components, built
+ * once from the constructor arguments, and the groups to join. Spawning
+ * copies the prototypes, so the work of a constructor (a texture lookup, a
+ * tag parse) is done once per prefab rather than once per entity.
+ *
+ * Prototypes are never initialised and never belong to an entity: init()
+ * runs on the copies, once they all exist. Batches are spawned by the
+ * manager:
+ *
+ *   Prefab enemy;
+ *   enemy.add<TransformComponent>(0.0f, 0.0f, 32, 32, 1);
+ *   enemy.add<SpriteComponent>("assets/enemy.png", true);
+ *   enemy.addGroup(groupColliders);
+ *
+ *   manager.spawnBatch(enemy, 1000, [](Entity &e, std::size_t i) {
+ *     e.getComponent<TransformComponent>().position = spawnPoints[i];
+ *   });
+ *
+ * @author: @iMeyu
+ */
+class Prefab {
+public:
+  // Replaces the prototype of T if there is one
+  template <typename T, typename... TArgs> T &add(TArgs &&...mArgs) {
+    auto &prototype = std::get<std::unique_ptr<T>>(prototypes);
+    prototype = std::make_unique<T>(std::forward<TArgs>(mArgs)...);
+    prototype->entity = nullptr;
+    return *prototype;
+  }
+
+  template <typename T> bool has() const {
+    return std::get<std::unique_ptr<T>>(prototypes) != nullptr;
+  }
+
+  void addGroup(Group group) { groups[group] = true; }
+
+  std::size_t componentCount() const {
+    return std::apply(
+        [](const auto &...prototype) {
+          return (std::size_t{0} + ... + (prototype ? 1 : 0));
+        },
+        prototypes);
+  }
+
+private:
+  friend class Manager;
+
+  PrototypesOf<ComponentTypes>::type prototypes; // Registry order
+  GroupBitset groups;
+};
+
+/**
+ * Spawn count entities from a prefab. The work is done a component type at
+ * a time, in registry order, instead of an entity at a time:
+ * 1. the entities are created, with room reserved once for all of them;
+ * 2. per type, every entity gets a copy of the prototype, and the type's
+ *    store grows once;
+ * 3. the entities join the prefab's groups;
+ * 4. initialiser(Entity &, std::size_t i) sets what differs per entity;
+ * 5. per type, init() runs on every copy, seeing the initialised values
+ *    and every sibling component.
+ * Unlike addEntity(), no EntitySpawnedEvent is emitted: a load of spawns
+ * would fill the event queue, and its capacity, with events nothing reads.
+ */
+template <typename F>
+void Manager::spawnBatch(const Prefab &prefab, std::size_t count,
+                         F &&initialiser) {
+  if (count == 0) {
+    return;
+  }
+
+  const std::size_t first = entities.size();
+  const std::size_t componentCount = prefab.componentCount();
+  entities.reserve(first + count);
+  // Events about entities (movements, finished animations, timers) can
+  // come from all of them in one tick: the queues grow now, not then
+  EventBus::Reserve(first + count);
+  for (std::size_t i = 0; i < count; i++) {
+    Entity *e = new Entity(*this);
+    e->phase = static_cast<std::uint8_t>(first + i);
+    e->components.reserve(componentCount);
+    entities.emplace_back(e);
+  }
+
+  std::apply(
+      [this, first, count](const auto &...prototype) {
+        auto copyAll = [this, first, count](const auto &prototype) {
+          using T = typename std::decay_t<decltype(prototype)>::element_type;
+          if (!prototype) {
+            return;
+          }
+          auto &store = getComponents<T>();
+          store.reserve(store.size() + count);
+          for (std::size_t i = first; i < first + count; i++) {
+            T &c = entities[i]->template emplaceComponent<T>(*prototype);
+            store.push_back(&c);
+            markAdded(c);
+          }
+        };
+        (copyAll(prototype), ...);
+      },
+      prefab.prototypes);
+  markAwakeChanged();
+
+  for (Group group = 0; group < maxGroups; group++) {
+    if (prefab.groups[group]) {
+      groupedEntities[group].reserve(groupedEntities[group].size() + count);
+      for (std::size_t i = first; i < first + count; i++) {
+        entities[i]->addGroup(group);
+      }
+    }
+  }
+
+  for (std::size_t i = 0; i < count; i++) {
+    initialiser(*entities[first + i], i);
+  }
+
+  std::apply(
+      [this, first, count](const auto &...prototype) {
+        auto initAll = [this, first, count](const auto &prototype) {
+          using T = typename std::decay_t<decltype(prototype)>::element_type;
+          if (!prototype) {
+            return;
+          }
+          for (std::size_t i = first; i < first + count; i++) {
+            entities[i]->template getComponent<T>().init();
+          }
+        };
+        (initAll(prototype), ...);
+      },
+      prefab.prototypes);
+}
+
+inline void Manager::spawnBatch(const Prefab &prefab, std::size_t count) {
+  spawnBatch(prefab, count, [](Entity &, std::size_t) {});
+}
+
+#endif
@@ -0,0 +1,137 @@
+#include "grid_raycast.hpp"
+#include <cmath>
+#include <limits>
+
+std::vector<std::uint8_t> GridRaycast::solid;
+int GridRaycast::width = 0;
+int GridRaycast::height = 0;
+int GridRaycast::cellSize = 1;
+
+namespace {
+
+constexpr float infinity = std::numeric_limits<float>::infinity();
+constexpr float fullCircle = 6.28318531f;
+
+} // namespace
+
+void GridRaycast::SetGrid(const std::vector<std::uint8_t> &cells, int w, int h,
+                          int size) {
+  solid = cells;
+  width = w;
+  height = h;
+  cellSize = size > 0 ? size : 1;
+}
+
+bool GridRaycast::solidAt(int cellX, int cellY) {
+  if (cellX < 0 || cellY < 0 || cellX >= width || cellY >= height) {
+    return true;
+  }
+  return solid[static_cast<std::size_t>(cellY) * width + cellX] != 0;
+}
+
+/**
+ * Trace a ray until it enters a solid cell or runs out of distance
+ */
+bool GridRaycast::Cast(const Ray &ray, RayHit &hit) {
+  hit = RayHit{};
+  hit.distance = ray.maxDistance;
+
+  const float length = ray.direction.Length();
+  if (length == 0.0f) {
+    hit.point = ray.origin;
+    return false;
+  }
+  const float dx = ray.direction.x / length;
+  const float dy = ray.direction.y / length;
+  const float size = static_cast<float>(cellSize);
+
+  int cellX = static_cast<int>(std::floor(ray.origin.x / size));
+  int cellY = static_cast<int>(std::floor(ray.origin.y / size));
+
+  float t = 0.0f;
+  if (!solidAt(cellX, cellY)) {
+    // Distance along the ray between two crossings of each axis, and to the
+    // first crossing
+    const int stepX = dx > 0.0f ? 1 : -1;
+    const int stepY = dy > 0.0f ? 1 : -1;
+    const float deltaX = dx != 0.0f ? size / std::fabs(dx) : infinity;
+    const float deltaY = dy != 0.0f ? size / std::fabs(dy) : infinity;
+    float nextX = infinity;
+    float nextY = infinity;
+    if (dx != 0.0f) {
+      const float edge = (dx > 0.0f ? cellX + 1 : cellX) * size;
+      nextX = (edge - ray.origin.x) / dx;
+    }
+    if (dy != 0.0f) {
+      const float edge = (dy > 0.0f ? cellY + 1 : cellY) * size;
+      nextY = (edge - ray.origin.y) / dy;
+    }
+
+    // Ends at the border at the latest, which is solid
+    while (true) {
+      if (nextX < nextY) {
+        t = nextX;
+        cellX += stepX;
+        nextX += deltaX;
+        hit.normal = {static_cast<float>(-stepX), 0.0f};
+      } else {
+        t = nextY;
+        cellY += stepY;
+        nextY += deltaY;
+        hit.normal = {0.0f, static_cast<float>(-stepY)};
+      }
+
+      if (t > ray.maxDistance) {
+        hit.normal = {};
+        hit.point = {ray.origin.x + dx * ray.maxDistance,
+                     ray.origin.y + dy * ray.maxDistance};
+        return false;
+      }
+      if (solidAt(cellX, cellY)) {
+        break;
+      }
+    }
+  }
+
+  hit.hit = true;
+  hit.distance = t;
+  hit.point = {ray.origin.x + dx * t, ray.origin.y + dy * t};
+  hit.cellX = cellX;
+  hit.cellY = cellY;
+  return true;
+}
+
+bool GridRaycast::LineOfSight(const Vector2D &from, const Vector2D &to) {
+  const Vector2D toTarget = to - from;
+  RayHit hit;
+  return !Cast({from, toTarget, toTarget.Length()}, hit);
+}
+
+std::size_t GridRaycast::CastBatch(const Ray *rays, RayHit *hits,
+                                   std::size_t count) {
+  std::size_t hitCount = 0;
+  for (std::size_t i = 0; i < count; i++) {
+    hitCount += Cast(rays[i], hits[i]) ? 1 : 0;
+  }
+  return hitCount;
+}
+
+std::size_t GridRaycast::CastFan(const Vector2D &origin, float startAngle,
+                                 float span, float maxDistance, RayHit *hits,
+                                 std::size_t count) {
+  if (count == 0) {
+    return 0;
+  }
+
+  const bool closed = std::fabs(span) >= fullCircle;
+  const std::size_t steps = (closed || count == 1) ? count : count - 1;
+  const float step = span / static_cast<float>(steps);
+
+  std::size_t hitCount = 0;
+  for (std::size_t i = 0; i < count; i++) {
+    const float angle = startAngle + step * static_cast<float>(i);
+    const Ray ray = {origin, {std::cos(angle), std::sin(angle)}, maxDistance};
+    hitCount += Cast(ray, hits[i]) ? 1 : 0;
+  }
+  return hitCount;
+}
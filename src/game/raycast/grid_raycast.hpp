@@ -0,0 +1,71 @@
+#ifndef GRID_RAYCAST_HPP
+#define GRID_RAYCAST_HPP
+
+#include "../vector2d/vector_2d.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * One ray, in world coordinates. The direction need not be normalised.
+ */
+struct Ray {
+  Vector2D origin;
+  Vector2D direction;
+  float maxDistance;
+};
+
+/**
+ * Where a ray stopped
+ */
+struct RayHit {
+  bool hit = false;    // A solid cell was reached within maxDistance
+  float distance = 0;  // To the hit, maxDistance when nothing was hit
+  Vector2D point;      // World position at distance
+  Vector2D normal;     // Face crossed into the solid cell, zero if started in
+  int cellX = -1;      // Solid cell hit
+  int cellY = -1;
+};
+
+/**
+ * GridRaycast class
+ *
+ * Ray queries against the solid cells of the map. A ray walks the grid one
+ * cell boundary at a time (DDA), so its cost grows with the number of cells
+ * crossed, not with the number of colliders. Cells outside the map are solid:
+ * every ray stops at the border at the latest.
+ *
+ * The batch functions trace many rays into a buffer the caller owns and do
+ * not allocate.
+ *
+ * @author: @iMeyu
+ */
+class GridRaycast {
+public:
+  // Copy the solid cells (row major, non-zero is solid)
+  static void SetGrid(const std::vector<std::uint8_t> &solid, int width,
+                      int height, int cellSize);
+
+  static bool Cast(const Ray &ray, RayHit &hit); // true on a hit
+  static bool LineOfSight(const Vector2D &from, const Vector2D &to);
+
+  // hits[i] receives the result of rays[i]; returns the number of hits
+  static std::size_t CastBatch(const Ray *rays, RayHit *hits,
+                               std::size_t count);
+
+  // count rays spread evenly over [startAngle, startAngle + span] radians,
+  // ends included; a full circle (span 2 pi) drops the duplicate last ray
+  static std::size_t CastFan(const Vector2D &origin, float startAngle,
+                             float span, float maxDistance, RayHit *hits,
+                             std::size_t count);
+
+private:
+  static bool solidAt(int cellX, int cellY);
+
+  static std::vector<std::uint8_t> solid;
+  static int width;
+  static int height;
+  static int cellSize;
+};
+
+#endif
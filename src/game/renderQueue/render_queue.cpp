@@ -0,0 +1,103 @@
+#include "render_queue.hpp"
+#include "../../textureManager/texture_manager.hpp"
+#include <algorithm>
+
+namespace {
+
+// Sort y is stored with this bias so rows above the world origin still
+// order correctly as unsigned digits
+constexpr int sortBias = 1 << (renderKeySortBits - 1);
+
+RenderKey packKey(int layer, int sortY, TextureHandle texture) {
+  const auto l = static_cast<RenderKey>(
+      std::clamp(layer, 0, (1 << renderKeyLayerBits) - 1));
+  const auto y = static_cast<RenderKey>(
+      std::clamp(sortY + sortBias, 0, (1 << renderKeySortBits) - 1));
+  return (l << (renderKeySortBits + renderKeyTextureBits)) |
+         (y << renderKeyTextureBits) | static_cast<RenderKey>(texture);
+}
+
+} // namespace
+
+RenderQueue::RenderQueue() {
+  // Reserve up front so steady-state frames do not reallocate
+  for (auto &buffer : buffers) {
+    buffer.reserve(1024);
+  }
+  order.reserve(1024);
+  scratch.reserve(1024);
+}
+
+void RenderQueue::begin(const SDL_Rect &camera) {
+  buffers[back].clear();
+  screens[back] = {0, 0, camera.w, camera.h};
+}
+
+void RenderQueue::submit(TextureHandle texture, const SDL_Rect &src,
+                         const SDL_Rect &dst, SDL_RendererFlip flip, int layer,
+                         int sortY) {
+  if (texture == 0 || !SDL_HasIntersection(&dst, &screens[back])) {
+    return;
+  }
+  buffers[back].push_back({texture, src, dst, flip,
+                           packKey(layer, sortY, texture)});
+}
+
+void RenderQueue::swap() { back = 1 - back; }
+
+/**
+ * Order the front buffer with a least-significant-digit radix sort, a byte
+ * per pass. Each pass is a stable counting sort, so after the last one the
+ * entries are ordered by the whole key and ties keep submission order.
+ * A pass where every key has the same byte would not move anything and is
+ * skipped: with one layer and one texture only the sort y bytes are sorted.
+ */
+void RenderQueue::sort() {
+  const auto &front = buffers[1 - back];
+  order.resize(front.size());
+  scratch.resize(front.size());
+  for (std::size_t i = 0; i < front.size(); i++) {
+    order[i] = {front[i].key, static_cast<std::uint32_t>(i)};
+  }
+  if (order.size() < 2) {
+    return;
+  }
+
+  for (int shift = 0; shift < renderKeyBits; shift += 8) {
+    std::array<std::uint32_t, 256> offsets{};
+    for (const SortEntry &entry : order) {
+      offsets[(entry.key >> shift) & 0xff]++;
+    }
+    if (offsets[(order[0].key >> shift) & 0xff] == order.size()) {
+      continue;
+    }
+
+    // Counts to first positions
+    std::uint32_t position = 0;
+    for (auto &offset : offsets) {
+      const std::uint32_t count = offset;
+      offset = position;
+      position += count;
+    }
+
+    for (const SortEntry &entry : order) {
+      scratch[offsets[(entry.key >> shift) & 0xff]++] = entry;
+    }
+    order.swap(scratch);
+  }
+}
+
+/**
+ * Draw every command of the front buffer in key order.
+ * Handles resolve to a placeholder until their texture is uploaded.
+ */
+void RenderQueue::flush() {
+  sort();
+
+  const auto &front = buffers[1 - back];
+  for (const SortEntry &entry : order) {
+    const RenderCommand &cmd = front[entry.index];
+    TextureManager::Draw(TextureManager::Get(cmd.texture), cmd.src, cmd.dst,
+                         cmd.flip);
+  }
+}
@@ -0,0 +1,83 @@
+#ifndef RENDER_QUEUE_HPP
+#define RENDER_QUEUE_HPP
+
+#include "../../textureManager/texture_manager.hpp"
+#include <SDL2/SDL.h>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Draw order of a command, packed so one integer compare orders it:
+// [layer: 8 bits][sort y: 24 bits][texture: 16 bits]. Same-texture draws of
+// a layer and row end up next to each other.
+using RenderKey = std::uint64_t;
+
+constexpr int renderKeyTextureBits = 16;
+constexpr int renderKeySortBits = 24;
+constexpr int renderKeyLayerBits = 8;
+constexpr int renderKeyBits =
+    renderKeyTextureBits + renderKeySortBits + renderKeyLayerBits;
+
+static_assert(maxTextures <= (std::size_t{1} << renderKeyTextureBits),
+              "Texture handles must fit in the render key");
+
+/**
+ * A single draw call recorded by the simulation.
+ * Plain data only: the render stage never touches components.
+ */
+struct RenderCommand {
+  TextureHandle texture;
+  SDL_Rect src;
+  SDL_Rect dst;
+  SDL_RendererFlip flip;
+  RenderKey key;
+};
+
+/**
+ * RenderQueue class
+ *
+ * Double-buffered list of render commands. The simulation writes the back
+ * buffer while the render stage submits the front one, so tick N+1 can be
+ * simulated while frame N is drawn and presented.
+ *
+ * Commands outside the screen are dropped when submitted. flush() orders
+ * the rest by layer, then by sort y (the feet of a sprite, so the lower one
+ * overlaps), then by texture, with a stable LSD radix sort: one counting
+ * pass per key byte, O(n), and commands with equal keys keep their
+ * submission order.
+ *
+ * submit() and begin() belong to the simulation, flush() to the render stage.
+ * swap() must only be called while neither of them is running.
+ */
+class RenderQueue {
+public:
+  RenderQueue();
+
+  // Clear the back buffer before a new tick records into it; commands
+  // outside a camera-sized screen are culled
+  void begin(const SDL_Rect &camera);
+  void submit(TextureHandle texture, const SDL_Rect &src, const SDL_Rect &dst,
+              SDL_RendererFlip flip, int layer, int sortY);
+  void swap();  // Publish the back buffer to the render stage
+  void flush(); // Issue the front buffer to the SDL renderer
+
+  std::size_t size() const { return buffers[1 - back].size(); }
+
+private:
+  // What the sort moves around: the key and the command it belongs to
+  struct SortEntry {
+    RenderKey key;
+    std::uint32_t index;
+  };
+
+  void sort(); // Fills order from the front buffer
+
+  std::array<std::vector<RenderCommand>, 2> buffers;
+  std::array<SDL_Rect, 2> screens{}; // Culling rectangle of each buffer
+  int back = 0; // Index of the buffer the simulation writes into
+
+  std::vector<SortEntry> order;   // Front buffer in draw order
+  std::vector<SortEntry> scratch; // Radix sort ping-pong buffer
+};
+
+#endif
@@ -0,0 +1,76 @@
+#include "simulation_lod.hpp"
+#include "../ECS/ECS.hpp"
+#include "../components/components.hpp"
+#include "../eventBus/event_bus.hpp"
+#include <algorithm>
+
+LodSettings SimulationLod::settings;
+
+namespace {
+
+// Pixels between the entity's box and the camera, per axis the larger
+float distanceToCamera(const TransformComponent &t, const SDL_Rect &camera) {
+  const float left = t.position.x;
+  const float top = t.position.y;
+  const float right = left + static_cast<float>(t.width * t.scale);
+  const float bottom = top + static_cast<float>(t.height * t.scale);
+
+  const float dx = std::max({static_cast<float>(camera.x) - right,
+                             left - static_cast<float>(camera.x + camera.w),
+                             0.0f});
+  const float dy = std::max({static_cast<float>(camera.y) - bottom,
+                             top - static_cast<float>(camera.y + camera.h),
+                             0.0f});
+  return std::max(dx, dy);
+}
+
+// Moved by something other than its own velocity: never put to sleep
+bool isDriven(const Entity &e) {
+  return e.hasComponent<KeyboardController>() ||
+         e.hasComponent<FollowDelayComponent>() ||
+         e.hasComponent<NavigationComponent>();
+}
+
+} // namespace
+
+void SimulationLod::Configure(Manager &manager, const LodSettings &lodSettings) {
+  settings = lodSettings;
+  settings.classifySlices = std::max<std::uint32_t>(settings.classifySlices, 1);
+  manager.setReducedInterval(settings.reducedInterval);
+}
+
+void SimulationLod::Update(Manager &manager, const SDL_Rect &camera) {
+  const auto &transforms = manager.getComponents<TransformComponent>();
+  const std::size_t slices = settings.classifySlices;
+
+  for (std::size_t i = manager.currentTick() % slices; i < transforms.size();
+       i += slices) {
+    const TransformComponent &t = *transforms[i];
+    Entity &e = *t.entity;
+    if (e.getActivity() == Activity::Static) {
+      continue;
+    }
+
+    const float limit = e.getActivity() == Activity::Active
+                            ? settings.reducedDistance + settings.hysteresis
+                            : settings.reducedDistance;
+    const bool atRest = t.velocity.x == 0.0f && t.velocity.y == 0.0f;
+
+    if (distanceToCamera(t, camera) <= limit) {
+      e.setActivity(Activity::Active);
+    } else if (atRest && !isDriven(e)) {
+      e.setActivity(Activity::Sleeping);
+    } else {
+      e.setActivity(Activity::Reduced);
+    }
+  }
+}
+
+void SimulationLod::WakeOnEvents() {
+  for (const auto &collision : EventBus::Events<CollisionEvent>()) {
+    collision.entity->wake();
+    if (collision.other) {
+      collision.other->wake();
+    }
+  }
+}
@@ -0,0 +1,54 @@
+#ifndef SIMULATION_LOD_HPP
+#define SIMULATION_LOD_HPP
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+
+class Manager;
+
+/**
+ * Tuning of the simulation level of detail
+ */
+struct LodSettings {
+  // Beyond this many pixels outside the camera an entity leaves full rate
+  float reducedDistance = 256.0f;
+  // Extra distance an active entity may drift before it is demoted, so one
+  // at the boundary does not flip every classification
+  float hysteresis = 64.0f;
+  // Reduced-rate entities update once every this many ticks
+  std::uint32_t reducedInterval = 4;
+  // Entities are classified once every this many ticks, a slice per tick
+  std::uint32_t classifySlices = 8;
+};
+
+/**
+ * SimulationLod class
+ *
+ * Decides the Activity of every entity with a transform from its distance
+ * to the camera, so the cost of a tick follows the region around the camera
+ * rather than the size of the world:
+ * - near the camera: active, updated every tick;
+ * - far and at rest, with nothing driving it (keyboard, leader, flow
+ *   field): sleeping, until the camera comes near or a collision wakes it;
+ * - far otherwise: reduced rate.
+ *
+ * Static entities (tiles, terrain) are marked by whoever creates them and
+ * are never reclassified.
+ *
+ * @author: @iMeyu
+ */
+class SimulationLod {
+public:
+  static void Configure(Manager &manager, const LodSettings &lodSettings);
+
+  // Classify this tick's slice of the entities; after Manager::beginTick
+  static void Update(Manager &manager, const SDL_Rect &camera);
+
+  // Wake the entities in this tick's CollisionEvents
+  static void WakeOnEvents();
+
+private:
+  static LodSettings settings;
+};
+
+#endif
@@ -0,0 +1,336 @@
+#include "snapshot.hpp"
+#include "../../utility/logger/logger.hpp"
+#include "../ECS/ECS.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+// [SnapshotHeader][Manager::save]
+constexpr char snapshotMagic[4] = {'W', 'S', 'N', 'P'};
+constexpr std::uint32_t snapshotVersion = 7;
+
+struct SnapshotHeader {
+  char magic[4];
+  std::uint32_t version;
+  SDL_Rect camera;
+  std::uint64_t bodySize; // Bytes after the header
+  std::uint64_t checksum; // Of those bytes
+};
+
+// Eight bytes at a time: taken for every tick's snapshot, so it has to be
+// cheap next to the capture
+std::uint64_t checksum(const std::uint8_t *data, std::size_t size) {
+  std::uint64_t hash = 0x9E3779B97F4A7C15ull ^ size;
+  std::size_t i = 0;
+  for (; size - i >= 8; i += 8) {
+    std::uint64_t word;
+    std::memcpy(&word, data + i, 8);
+    hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 32;
+  }
+  std::uint64_t tail = 0;
+  std::memcpy(&tail, data + i, size - i);
+  hash = (hash ^ tail) * 0xFF51AFD7ED558CCDull;
+  return hash ^ (hash >> 32);
+}
+
+// Delta: [size of the result] then [unchanged, changed, changed bytes]...
+// until the result is complete
+void writeU32(std::vector<std::uint8_t> &out, std::uint32_t value) {
+  const auto *bytes = reinterpret_cast<const std::uint8_t *>(&value);
+  out.insert(out.end(), bytes, bytes + sizeof(value));
+}
+
+bool readU32(const std::vector<std::uint8_t> &in, std::size_t &offset,
+             std::uint32_t &value) {
+  if (in.size() - offset < sizeof(value)) {
+    return false;
+  }
+  std::memcpy(&value, in.data() + offset, sizeof(value));
+  offset += sizeof(value);
+  return true;
+}
+
+// Length of the run starting at i where a and b agree (equal) or differ
+std::size_t runLength(const std::uint8_t *a, const std::uint8_t *b,
+                      std::size_t i, std::size_t end, bool equal) {
+  const std::size_t start = i;
+
+  // Eight bytes at a time while the run lasts
+  while (end - i >= 8) {
+    std::uint64_t wa, wb;
+    std::memcpy(&wa, a + i, 8);
+    std::memcpy(&wb, b + i, 8);
+    if ((wa == wb) != equal) {
+      break;
+    }
+    i += 8;
+  }
+  while (i < end && (a[i] == b[i]) == equal) {
+    i++;
+  }
+  return i - start;
+}
+
+// Room reserved per ring slot, in snapshots: keyframes for a growing world,
+// deltas for the ticks that change the most
+constexpr std::size_t keyframeRoom = 2;
+constexpr std::size_t deltaRoomDivisor = 2;
+
+// Changed runs shorter than this are merged with a following short
+// unchanged run: 8 bytes of run header cost more than the bytes they skip
+constexpr std::size_t minUnchangedRun = 8;
+
+} // namespace
+
+void SnapshotWriter::writeString(const std::string &value) {
+  write(static_cast<std::uint32_t>(value.size()));
+  buffer.insert(buffer.end(), value.begin(), value.end());
+}
+
+void SnapshotWriter::writeEntity(const Entity *entity) {
+  write(entity ? entity->snapshotIndex() : noSnapshotEntity);
+}
+
+bool SnapshotReader::readString(std::string &value) {
+  std::uint32_t length = 0;
+  if (!read(length) || size - offset < length) {
+    failed = true;
+    return false;
+  }
+  value.assign(reinterpret_cast<const char *>(data + offset), length);
+  offset += length;
+  return true;
+}
+
+Entity *SnapshotReader::readEntity() {
+  std::uint32_t index = noSnapshotEntity;
+  if (!read(index) || index == noSnapshotEntity || !entities ||
+      index >= entities->size()) {
+    return nullptr;
+  }
+  return (*entities)[index];
+}
+
+/**
+ * Save the world into out, replacing its content
+ */
+void WorldSnapshot::Capture(Manager &manager, const SDL_Rect &camera,
+                            std::vector<std::uint8_t> &out) {
+  SnapshotWriter writer(out);
+
+  SnapshotHeader header;
+  std::memcpy(header.magic, snapshotMagic, sizeof(snapshotMagic));
+  header.version = snapshotVersion;
+  header.camera = camera;
+  header.bodySize = 0;
+  header.checksum = 0;
+  writer.write(header);
+
+  manager.save(writer);
+
+  // Filled in once the body is written
+  header.bodySize = out.size() - sizeof(header);
+  header.checksum = checksum(out.data() + sizeof(header), header.bodySize);
+  std::memcpy(out.data(), &header, sizeof(header));
+}
+
+/**
+ * Put the world back in the state of a snapshot. Nothing is changed if the
+ * snapshot is truncated or corrupt: its size and checksum are checked before
+ * the world is.
+ */
+bool WorldSnapshot::Restore(Manager &manager, SDL_Rect &camera,
+                            const std::vector<std::uint8_t> &snapshot) {
+  SnapshotReader reader(snapshot.data(), snapshot.size());
+
+  SnapshotHeader header;
+  if (!reader.read(header) ||
+      std::memcmp(header.magic, snapshotMagic, sizeof(snapshotMagic)) != 0 ||
+      header.version != snapshotVersion) {
+    LOG_ERROR("Invalid world snapshot");
+    return false;
+  }
+
+  const std::uint8_t *body = snapshot.data() + sizeof(header);
+  if (header.bodySize != reader.remaining() ||
+      header.checksum != checksum(body, reader.remaining())) {
+    LOG_ERROR("Corrupt world snapshot");
+    return false;
+  }
+
+  if (!manager.load(reader)) {
+    LOG_ERROR("Corrupt world snapshot");
+    return false;
+  }
+
+  camera = header.camera;
+  return true;
+}
+
+void WorldSnapshot::Diff(const std::vector<std::uint8_t> &base,
+                         const std::vector<std::uint8_t> &current,
+                         std::vector<std::uint8_t> &delta) {
+  delta.clear();
+  writeU32(delta, static_cast<std::uint32_t>(current.size()));
+
+  const std::size_t common = std::min(base.size(), current.size());
+  std::size_t i = 0;
+
+  while (i < current.size()) {
+    std::size_t unchanged = 0;
+    if (i < common) {
+      unchanged = runLength(base.data(), current.data(), i, common, true);
+    }
+
+    // Everything past the end of base is changed
+    std::size_t changedEnd = i + unchanged;
+    while (changedEnd < current.size()) {
+      if (changedEnd >= common) {
+        changedEnd = current.size();
+        break;
+      }
+      changedEnd += runLength(base.data(), current.data(), changedEnd, common,
+                              false);
+      const std::size_t gap =
+          runLength(base.data(), current.data(), changedEnd, common, true);
+      if (gap >= minUnchangedRun || changedEnd + gap == current.size()) {
+        break;
+      }
+      changedEnd += gap;
+    }
+
+    const std::size_t changed = changedEnd - (i + unchanged);
+    writeU32(delta, static_cast<std::uint32_t>(unchanged));
+    writeU32(delta, static_cast<std::uint32_t>(changed));
+    delta.insert(delta.end(), current.begin() + (i + unchanged),
+                 current.begin() + changedEnd);
+    i = changedEnd;
+  }
+}
+
+bool WorldSnapshot::Patch(const std::vector<std::uint8_t> &base,
+                          const std::vector<std::uint8_t> &delta,
+                          std::vector<std::uint8_t> &out) {
+  std::size_t offset = 0;
+  std::uint32_t size = 0;
+  if (!readU32(delta, offset, size)) {
+    return false;
+  }
+
+  out.resize(size);
+  std::size_t i = 0;
+  while (i < size) {
+    std::uint32_t unchanged = 0;
+    std::uint32_t changed = 0;
+    if (!readU32(delta, offset, unchanged) || !readU32(delta, offset, changed) ||
+        unchanged > size - i || changed > size - i - unchanged ||
+        i + unchanged > base.size() || delta.size() - offset < changed) {
+      return false;
+    }
+
+    std::memcpy(out.data() + i, base.data() + i, unchanged);
+    i += unchanged;
+    std::memcpy(out.data() + i, delta.data() + offset, changed);
+    i += changed;
+    offset += changed;
+  }
+  return offset == delta.size();
+}
+
+SnapshotHistory::SnapshotHistory(std::size_t capacity,
+                                 std::size_t keyframeInterval)
+    : entries(capacity > 1 ? capacity : 2),
+      keyframeInterval(keyframeInterval > 0 ? keyframeInterval : 1) {}
+
+SnapshotHistory::Entry &SnapshotHistory::at(std::size_t age) {
+  return entries[(newest + entries.size() - age) % entries.size()];
+}
+
+/**
+ * Size every slot from the first snapshot. Keyframes land every
+ * keyframeInterval slots after the next one.
+ */
+void SnapshotHistory::reserve(std::size_t snapshotSize) {
+  for (std::size_t k = 1; k <= entries.size(); k++) {
+    Entry &entry = entries[(newest + k) % entries.size()];
+    const bool keyframe = (k - 1) % keyframeInterval == 0;
+    entry.data.reserve(keyframe ? snapshotSize * keyframeRoom
+                                : snapshotSize / deltaRoomDivisor);
+  }
+  last.reserve(snapshotSize * keyframeRoom);
+  scratch.reserve(snapshotSize * keyframeRoom);
+  reserved = true;
+}
+
+/**
+ * Record the newest tick
+ */
+void SnapshotHistory::Push(const std::vector<std::uint8_t> &snapshot) {
+  if (!reserved) {
+    reserve(snapshot.size());
+  }
+
+  // Evict the oldest tick; the deltas that depended on it go with it, up to
+  // the next keyframe
+  if (count == entries.size()) {
+    count--;
+    while (count > 0 && !at(count - 1).keyframe) {
+      count--;
+    }
+  }
+
+  const bool keyframe = count == 0 || sinceKeyframe + 1 >= keyframeInterval;
+  newest = (newest + 1) % entries.size();
+  Entry &entry = entries[newest];
+  entry.keyframe = keyframe;
+  if (keyframe) {
+    entry.data = snapshot;
+    sinceKeyframe = 0;
+  } else {
+    WorldSnapshot::Diff(last, snapshot, entry.data);
+    sinceKeyframe++;
+  }
+  count++;
+  last = snapshot;
+}
+
+bool SnapshotHistory::StepBack(std::vector<std::uint8_t> &out) {
+  if (count < 2) {
+    return false;
+  }
+
+  newest = (newest + entries.size() - 1) % entries.size();
+  count--;
+
+  // Patch forward from the newest keyframe; the oldest stored tick is
+  // always one
+  std::size_t age = 0;
+  while (age + 1 < count && !at(age).keyframe) {
+    age++;
+  }
+  sinceKeyframe = age;
+
+  out = at(age).data;
+  while (age > 0) {
+    age--;
+    if (!WorldSnapshot::Patch(out, at(age).data, scratch)) {
+      count = 0;
+      return false;
+    }
+    std::swap(out, scratch);
+  }
+
+  last = out;
+  return true;
+}
+
+std::size_t SnapshotHistory::Bytes() const {
+  std::size_t bytes = 0;
+  for (std::size_t age = 0; age < count; age++) {
+    bytes += entries[(newest + entries.size() - age) % entries.size()]
+                 .data.size();
+  }
+  return bytes;
+}
@@ -0,0 +1,155 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+class Entity;
+class Manager;
+
+// Entity reference that points nowhere
+constexpr std::uint32_t noSnapshotEntity = 0xFFFFFFFF;
+
+/**
+ * Appends state to a snapshot buffer. The buffer is cleared, not released,
+ * so capturing into the same buffer every tick does not allocate.
+ */
+class SnapshotWriter {
+public:
+  explicit SnapshotWriter(std::vector<std::uint8_t> &buffer) : buffer(buffer) {
+    buffer.clear();
+  }
+
+  template <typename T> void write(const T &value) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Only plain values are written as raw bytes");
+    const auto *bytes = reinterpret_cast<const std::uint8_t *>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+  }
+
+  void writeString(const std::string &value);
+  void writeEntity(const Entity *entity); // As its index in the manager
+
+private:
+  std::vector<std::uint8_t> &buffer;
+};
+
+/**
+ * Reads state back in the order it was written. Reading past the end fails
+ * once and leaves every later value untouched.
+ */
+class SnapshotReader {
+public:
+  SnapshotReader(const std::uint8_t *data, std::size_t size)
+      : data(data), size(size) {}
+
+  template <typename T> bool read(T &value) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Only plain values are read as raw bytes");
+    if (failed || size - offset < sizeof(T)) {
+      failed = true;
+      return false;
+    }
+    std::memcpy(&value, data + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+  }
+
+  bool readString(std::string &value);
+  Entity *readEntity(); // nullptr for noSnapshotEntity or a bad index
+
+  // Entities in snapshot order, set by the manager before components load
+  void setEntities(const std::vector<Entity *> *list) { entities = list; }
+
+  bool ok() const { return !failed; }
+  bool atEnd() const { return offset == size; }
+  std::size_t remaining() const { return size - offset; }
+
+private:
+  const std::uint8_t *data;
+  std::size_t size;
+  std::size_t offset = 0;
+  bool failed = false;
+  const std::vector<Entity *> *entities = nullptr;
+};
+
+/**
+ * WorldSnapshot class
+ *
+ * Saves the whole simulation into one contiguous buffer: the camera, every
+ * entity with its groups and component state, and the order of the groups
+ * and component stores. Restoring matches entities by position, keeps the
+ * ones whose component set is unchanged (references held elsewhere stay
+ * valid) and recreates the rest, then re-links every pointer between
+ * entities and components. The header holds the size and a checksum of the
+ * rest, checked before the world is touched.
+ *
+ * Diff() encodes a snapshot against an earlier one as runs of unchanged and
+ * changed bytes; most of a tick's snapshot is unchanged, so deltas are small.
+ *
+ * @author: @iMeyu
+ */
+class WorldSnapshot {
+public:
+  static void Capture(Manager &manager, const SDL_Rect &camera,
+                      std::vector<std::uint8_t> &out);
+  static bool Restore(Manager &manager, SDL_Rect &camera,
+                      const std::vector<std::uint8_t> &snapshot);
+
+  // Bytes of current that differ from base
+  static void Diff(const std::vector<std::uint8_t> &base,
+                   const std::vector<std::uint8_t> &current,
+                   std::vector<std::uint8_t> &delta);
+  // Rebuild the snapshot Diff() was given; false for a corrupt delta
+  static bool Patch(const std::vector<std::uint8_t> &base,
+                    const std::vector<std::uint8_t> &delta,
+                    std::vector<std::uint8_t> &out);
+};
+
+/**
+ * The last ticks of the simulation, for rewinding. Every keyframeInterval
+ * ticks a full snapshot is kept; the ticks in between are stored as deltas
+ * against the tick before them.
+ *
+ * Every slot of the ring is reserved on the first Push(), so recording does
+ * not allocate while the history fills up; a slot only grows again when the
+ * world outgrows the room it was given.
+ */
+class SnapshotHistory {
+public:
+  explicit SnapshotHistory(std::size_t capacity,
+                           std::size_t keyframeInterval = 30);
+
+  void Push(const std::vector<std::uint8_t> &snapshot);
+
+  // Drop the newest tick and rebuild the one before it into out
+  bool StepBack(std::vector<std::uint8_t> &out);
+
+  std::size_t Size() const { return count; }
+  std::size_t Bytes() const; // Stored, after delta compression
+
+private:
+  struct Entry {
+    bool keyframe = false;
+    std::vector<std::uint8_t> data; // Full snapshot or delta
+  };
+
+  Entry &at(std::size_t age); // 0 is the newest tick
+  void reserve(std::size_t snapshotSize);
+
+  std::vector<Entry> entries; // Ring
+  std::size_t newest = 0;
+  std::size_t count = 0;
+  std::size_t keyframeInterval;
+  std::size_t sinceKeyframe = 0;
+  std::vector<std::uint8_t> last;    // Newest full snapshot
+  std::vector<std::uint8_t> scratch; // Rebuild space
+  bool reserved = false;
+};
+
+#endif
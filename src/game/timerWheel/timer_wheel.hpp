@@ -0,0 +1,363 @@
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Names a scheduled timer. A slot is reused once its timer is done, with a
+ * new generation, so an old id never refers to another timer.
+ */
+struct TimerId {
+  std::uint32_t slot = 0;
+  std::uint32_t generation = 0; // 0: no timer
+};
+
+/**
+ * TimerWheel class
+ *
+ * Timers due at a tick, each carrying a value of type T, kept in a
+ * hierarchical timing wheel: four levels of 64 slots, each slot of a level
+ * spanning a whole turn of the level below. A timer is linked in the slot
+ * of the highest level where its due tick differs from the clock, and moves
+ * down a level when the clock enters that slot. Scheduling, cancelling and
+ * rescheduling unlink and link one node; a tick visits one slot of the
+ * first level, plus one of a higher level every 64 ticks. Timers further
+ * than 64^4 ticks wait in an overflow list looked at once per full turn.
+ *
+ * The timers due at a tick fire as one batch, in the order they were
+ * scheduled, whatever path they took through the levels.
+ *
+ * @author: @iMeyu
+ */
+template <typename T> class TimerWheel {
+public:
+  // A pending timer, as listed by ForEach and put back by Restore
+  struct Timer {
+    TimerId id;
+    std::uint64_t due;      // Tick it fires at
+    std::uint64_t sequence; // Timers due at the same tick fire in this order
+    std::uint32_t period;   // Ticks between repeats, 0: fires once
+    T value;
+  };
+
+  TimerWheel() {
+    heads.fill(none);
+    nodes.reserve(256);
+    freeNodes.reserve(256);
+    firing.reserve(64);
+  }
+
+  // A due tick not after the clock fires at the next tick
+  TimerId Schedule(std::uint64_t due, const T &value,
+                   std::uint32_t period = 0);
+  bool Cancel(TimerId id); // false if it already fired or was cancelled
+  bool Reschedule(TimerId id, std::uint64_t due);
+  bool IsPending(TimerId id) const;
+
+  /**
+   * Move the clock forward to tick to, firing the timers due on the way:
+   * fire(TimerId, const T &) for each. fire may schedule and cancel timers,
+   * its own included; a repeating timer it does not reschedule or cancel is
+   * scheduled again period ticks later. fire must not call Advance.
+   */
+  template <typename F> void Advance(std::uint64_t to, F &&fire);
+
+  template <typename P> void CancelIf(P &&pred); // pred(const T &)
+  template <typename F> void ForEach(F &&f) const; // f(const Timer &)
+
+  void Reserve(std::size_t timers); // Room for this many pending timers
+  void Reset(std::uint64_t clock);  // Cancel every timer and set the clock
+  void Restore(const Timer &timer); // After Reset: put back a listed timer
+
+  std::uint64_t Now() const { return now; }
+  std::size_t Size() const { return live; }
+
+private:
+  static constexpr int slotBits = 6;
+  static constexpr std::uint32_t slotCount = 1u << slotBits;
+  static constexpr int levelCount = 4;
+  static constexpr std::uint32_t overflowBucket = levelCount * slotCount;
+  static constexpr std::uint32_t bucketCount = overflowBucket + 1;
+  static constexpr std::uint32_t none = 0xFFFFFFFF;
+
+  struct Node {
+    Timer timer{};
+    std::uint32_t prev = none;
+    std::uint32_t next = none;
+    std::uint32_t bucket = none; // none: free, or firing
+    bool pending = false;
+  };
+
+  std::uint32_t bucketFor(std::uint64_t due) const;
+  void link(std::uint32_t slot);
+  void unlink(std::uint32_t slot);
+  void release(std::uint32_t slot);
+  void cascade(std::uint32_t bucket);
+  template <typename F> void fireBucket(std::uint32_t bucket, F &fire);
+
+  std::vector<Node> nodes;
+  std::vector<std::uint32_t> freeNodes;
+  std::array<std::uint32_t, bucketCount> heads; // First node of each slot
+  std::vector<TimerId> firing;                  // Batch of the current tick
+
+  std::uint64_t now = 0;
+  std::uint64_t nextSequence = 0;
+  std::size_t live = 0;
+};
+
+template <typename T>
+TimerId TimerWheel<T>::Schedule(std::uint64_t due, const T &value,
+                                std::uint32_t period) {
+  std::uint32_t slot;
+  if (!freeNodes.empty()) {
+    slot = freeNodes.back();
+    freeNodes.pop_back();
+  } else {
+    slot = static_cast<std::uint32_t>(nodes.size());
+    nodes.emplace_back();
+  }
+
+  Node &node = nodes[slot];
+  const std::uint32_t generation = node.timer.id.generation + 1;
+  node.timer = {{slot, generation == 0 ? 1 : generation},
+                std::max(due, now + 1),
+                nextSequence++,
+                period,
+                value};
+  node.pending = true;
+  live++;
+  link(slot);
+  return node.timer.id;
+}
+
+template <typename T> bool TimerWheel<T>::Cancel(TimerId id) {
+  if (!IsPending(id)) {
+    return false;
+  }
+  unlink(id.slot);
+  release(id.slot);
+  return true;
+}
+
+template <typename T>
+bool TimerWheel<T>::Reschedule(TimerId id, std::uint64_t due) {
+  if (!IsPending(id)) {
+    return false;
+  }
+  unlink(id.slot);
+  Timer &timer = nodes[id.slot].timer;
+  timer.due = std::max(due, now + 1);
+  timer.sequence = nextSequence++;
+  link(id.slot);
+  return true;
+}
+
+template <typename T> bool TimerWheel<T>::IsPending(TimerId id) const {
+  return id.generation != 0 && id.slot < nodes.size() &&
+         nodes[id.slot].pending &&
+         nodes[id.slot].timer.id.generation == id.generation;
+}
+
+template <typename T>
+template <typename F>
+void TimerWheel<T>::Advance(std::uint64_t to, F &&fire) {
+  while (now < to) {
+    if (live == 0) {
+      now = to; // Nothing to visit on the way
+      return;
+    }
+    now++;
+
+    // Higher levels first: what they hand down may land in the slot of a
+    // lower level entered at the same tick
+    constexpr std::uint64_t turn = std::uint64_t{1}
+                                   << (slotBits * levelCount);
+    if ((now & (turn - 1)) == 0) {
+      cascade(overflowBucket);
+    }
+    for (int level = levelCount - 1; level > 0; level--) {
+      const int shift = slotBits * level;
+      if ((now & ((std::uint64_t{1} << shift) - 1)) == 0) {
+        cascade(level * slotCount +
+                static_cast<std::uint32_t>((now >> shift) & (slotCount - 1)));
+      }
+    }
+
+    fireBucket(static_cast<std::uint32_t>(now & (slotCount - 1)), fire);
+  }
+}
+
+template <typename T>
+template <typename P>
+void TimerWheel<T>::CancelIf(P &&pred) {
+  for (std::uint32_t slot = 0; slot < nodes.size(); slot++) {
+    if (nodes[slot].pending && pred(nodes[slot].timer.value)) {
+      unlink(slot);
+      release(slot);
+    }
+  }
+}
+
+template <typename T>
+template <typename F>
+void TimerWheel<T>::ForEach(F &&f) const {
+  for (const Node &node : nodes) {
+    if (node.pending) {
+      f(node.timer);
+    }
+  }
+}
+
+template <typename T> void TimerWheel<T>::Reserve(std::size_t timers) {
+  nodes.reserve(timers);
+  freeNodes.reserve(timers);
+  firing.reserve(timers);
+}
+
+template <typename T> void TimerWheel<T>::Reset(std::uint64_t clock) {
+  heads.fill(none);
+  freeNodes.clear();
+  // Listed backwards so the lowest slots are reused first
+  for (std::uint32_t slot = static_cast<std::uint32_t>(nodes.size());
+       slot-- > 0;) {
+    Node &node = nodes[slot];
+    node.prev = node.next = node.bucket = none;
+    node.pending = false;
+    freeNodes.push_back(slot);
+  }
+  now = clock;
+  live = 0;
+}
+
+template <typename T> void TimerWheel<T>::Restore(const Timer &timer) {
+  const std::uint32_t slot = timer.id.slot;
+  if (timer.id.generation == 0) {
+    return;
+  }
+  while (nodes.size() <= slot) {
+    // New slots go under the existing ones in the free list, which is
+    // popped from the back
+    freeNodes.insert(freeNodes.begin(),
+                     static_cast<std::uint32_t>(nodes.size()));
+    nodes.emplace_back();
+  }
+  if (nodes[slot].pending) {
+    return; // Listed twice
+  }
+  freeNodes.erase(std::find(freeNodes.begin(), freeNodes.end(), slot));
+
+  Node &node = nodes[slot];
+  node.timer = timer;
+  node.timer.due = std::max(timer.due, now + 1);
+  node.pending = true;
+  nextSequence = std::max(nextSequence, timer.sequence + 1);
+  live++;
+  link(slot);
+}
+
+template <typename T>
+std::uint32_t TimerWheel<T>::bucketFor(std::uint64_t due) const {
+  // The highest group of slot bits where due and the clock differ
+  const std::uint64_t differ = due ^ now;
+  for (int level = 0; level < levelCount; level++) {
+    const int shift = slotBits * level;
+    if ((differ >> (shift + slotBits)) == 0) {
+      return level * slotCount +
+             static_cast<std::uint32_t>((due >> shift) & (slotCount - 1));
+    }
+  }
+  return overflowBucket;
+}
+
+template <typename T> void TimerWheel<T>::link(std::uint32_t slot) {
+  Node &node = nodes[slot];
+  node.bucket = bucketFor(node.timer.due);
+  node.prev = none;
+  node.next = heads[node.bucket];
+  if (node.next != none) {
+    nodes[node.next].prev = slot;
+  }
+  heads[node.bucket] = slot;
+}
+
+template <typename T> void TimerWheel<T>::unlink(std::uint32_t slot) {
+  Node &node = nodes[slot];
+  if (node.bucket == none) {
+    return; // Firing
+  }
+  if (node.prev != none) {
+    nodes[node.prev].next = node.next;
+  } else {
+    heads[node.bucket] = node.next;
+  }
+  if (node.next != none) {
+    nodes[node.next].prev = node.prev;
+  }
+  node.prev = node.next = node.bucket = none;
+}
+
+template <typename T> void TimerWheel<T>::release(std::uint32_t slot) {
+  nodes[slot].pending = false;
+  freeNodes.push_back(slot);
+  live--;
+}
+
+// Relink every timer of a slot the clock just entered, a level lower
+template <typename T> void TimerWheel<T>::cascade(std::uint32_t bucket) {
+  std::uint32_t slot = heads[bucket];
+  heads[bucket] = none;
+  while (slot != none) {
+    const std::uint32_t next = nodes[slot].next;
+    link(slot);
+    slot = next;
+  }
+}
+
+template <typename T>
+template <typename F>
+void TimerWheel<T>::fireBucket(std::uint32_t bucket, F &fire) {
+  // Every timer of the first level slot of the clock is due now
+  firing.clear();
+  for (std::uint32_t slot = heads[bucket]; slot != none;
+       slot = nodes[slot].next) {
+    firing.push_back(nodes[slot].timer.id);
+  }
+  heads[bucket] = none;
+  for (const TimerId id : firing) {
+    nodes[id.slot].prev = nodes[id.slot].next = nodes[id.slot].bucket = none;
+  }
+  std::sort(firing.begin(), firing.end(), [this](TimerId a, TimerId b) {
+    return nodes[a.slot].timer.sequence < nodes[b.slot].timer.sequence;
+  });
+
+  // fire may schedule timers and grow nodes: nothing is referenced across
+  // the call, and the batch is walked by index
+  for (std::size_t i = 0; i < firing.size(); i++) {
+    const TimerId id = firing[i];
+    const std::uint32_t slot = id.slot;
+    if (!IsPending(id)) {
+      continue; // Cancelled by an earlier timer of the batch
+    }
+
+    const T value = nodes[slot].timer.value;
+    fire(id, value);
+
+    Node &node = nodes[slot];
+    if (!node.pending || node.timer.id.generation != id.generation ||
+        node.bucket != none) {
+      continue; // Cancelled or rescheduled by fire
+    }
+    if (node.timer.period > 0) {
+      node.timer.due = now + node.timer.period;
+      node.timer.sequence = nextSequence++;
+      link(slot);
+    } else {
+      release(slot);
+    }
+  }
+}
+
+#endif
@@ -1,34 +1,114 @@
 #ifndef VECTOR_2D_HPP
 #define VECTOR_2D_HPP
 
-#include <iostream>
+#include <cmath>
+#include <iosfwd>
+#include <type_traits>
 
+/**
+ * 2D vector with value semantics.
+ * Binary operators return a new vector and never modify their operands;
+ * the compound operators and Add/Subtract/Multiply/Divide modify in place.
+ * Everything except the length is constexpr.
+ */
 class Vector2D {
 public:
   float x = 0.0f;
   float y = 0.0f;
 
-  Vector2D();
-  Vector2D(float x, float y);
+  constexpr Vector2D() = default;
 
-  Vector2D &Add(const Vector2D &vec);
-  Vector2D &Subtract(const Vector2D &vec);
-  Vector2D &Multiply(const Vector2D &vec);
-  Vector2D &Divide(const Vector2D &vec);
+  /**
+   * @brief Constructor for Vector2D
+   * @param x The x coordinate of the vector
+   * @param y The y coordinate of the vector
+   */
+  constexpr Vector2D(float x, float y) : x(x), y(y) {}
 
-  friend Vector2D &operator+(Vector2D &v1, const Vector2D &v2);
-  friend Vector2D &operator-(Vector2D &v1, const Vector2D &v2);
-  friend Vector2D &operator*(Vector2D &v1, const Vector2D &v2);
-  friend Vector2D &operator/(Vector2D &v1, const Vector2D &v2);
+  constexpr Vector2D &Add(const Vector2D &vec) {
+    x += vec.x;
+    y += vec.y;
+    return *this;
+  }
 
-  Vector2D &operator+=(const Vector2D &vec);
-  Vector2D &operator-=(const Vector2D &vec);
-  Vector2D &operator*=(const Vector2D &vec);
-  Vector2D &operator/=(const Vector2D &vec);
+  constexpr Vector2D &Subtract(const Vector2D &vec) {
+    x -= vec.x;
+    y -= vec.y;
+    return *this;
+  }
 
-  Vector2D &operator*(const int &i);
-  Vector2D &Zero();
+  constexpr Vector2D &Multiply(const Vector2D &vec) {
+    x *= vec.x;
+    y *= vec.y;
+    return *this;
+  }
+
+  constexpr Vector2D &Divide(const Vector2D &vec) {
+    x /= vec.x;
+    y /= vec.y;
+    return *this;
+  }
+
+  constexpr Vector2D &operator+=(const Vector2D &vec) { return Add(vec); }
+  constexpr Vector2D &operator-=(const Vector2D &vec) { return Subtract(vec); }
+  constexpr Vector2D &operator*=(const Vector2D &vec) { return Multiply(vec); }
+  constexpr Vector2D &operator/=(const Vector2D &vec) { return Divide(vec); }
+
+  constexpr Vector2D &operator*=(float s) {
+    x *= s;
+    y *= s;
+    return *this;
+  }
+
+  constexpr Vector2D &Zero() {
+    x = 0.0f;
+    y = 0.0f;
+    return *this;
+  }
+
+  constexpr float Dot(const Vector2D &vec) const { return x * vec.x + y * vec.y; }
+  constexpr float LengthSquared() const { return Dot(*this); }
+  float Length() const { return std::sqrt(LengthSquared()); }
+
+  /**
+   * @brief Unit vector with the same direction, or the zero vector
+   */
+  Vector2D Normalized() const {
+    const float length = Length();
+    return length > 0.0f ? Vector2D(x / length, y / length) : Vector2D();
+  }
+
+  friend constexpr Vector2D operator+(Vector2D v1, const Vector2D &v2) {
+    return v1 += v2;
+  }
+  friend constexpr Vector2D operator-(Vector2D v1, const Vector2D &v2) {
+    return v1 -= v2;
+  }
+  friend constexpr Vector2D operator*(Vector2D v1, const Vector2D &v2) {
+    return v1 *= v2;
+  }
+  friend constexpr Vector2D operator/(Vector2D v1, const Vector2D &v2) {
+    return v1 /= v2;
+  }
+
+  friend constexpr Vector2D operator*(Vector2D vec, float s) { return vec *= s; }
+  friend constexpr Vector2D operator*(float s, Vector2D vec) { return vec *= s; }
+
+  friend constexpr bool operator==(const Vector2D &v1, const Vector2D &v2) {
+    return v1.x == v2.x && v1.y == v2.y;
+  }
+  friend constexpr bool operator!=(const Vector2D &v1, const Vector2D &v2) {
+    return !(v1 == v2);
+  }
 
   friend std::ostream &operator<<(std::ostream &stream, const Vector2D &vec);
 };
-#endif
\ No newline at end of file
+
+// Vectors are copied around freely and stored in SoA arrays by the batch
+// kernels, so they must stay plain data
+static_assert(std::is_trivially_copyable<Vector2D>::value,
+              "Vector2D must be trivially copyable");
+static_assert(sizeof(Vector2D) == 2 * sizeof(float),
+              "Vector2D must be two packed floats");
+
+#endif
@@ -0,0 +1,271 @@
+#include "vector_batch.hpp"
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define VECTOR_BATCH_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VECTOR_BATCH_SSE2 1
+#endif
+
+namespace {
+
+#if defined(VECTOR_BATCH_AVX)
+constexpr std::size_t lanes = 8;
+#elif defined(VECTOR_BATCH_SSE2)
+constexpr std::size_t lanes = 4;
+#else
+constexpr std::size_t lanes = 1;
+#endif
+
+// First index the scalar tail has to handle
+constexpr std::size_t simdEnd(std::size_t count) {
+  return count - count % lanes;
+}
+
+} // namespace
+
+void VectorBatch::Add(float *xs, float *ys, const float *dxs, const float *dys,
+                      std::size_t count) {
+  std::size_t i = 0;
+
+#if defined(VECTOR_BATCH_AVX)
+  for (; i < simdEnd(count); i += lanes) {
+    _mm256_storeu_ps(xs + i, _mm256_add_ps(_mm256_loadu_ps(xs + i),
+                                           _mm256_loadu_ps(dxs + i)));
+    _mm256_storeu_ps(ys + i, _mm256_add_ps(_mm256_loadu_ps(ys + i),
+                                           _mm256_loadu_ps(dys + i)));
+  }
+#elif defined(VECTOR_BATCH_SSE2)
+  for (; i < simdEnd(count); i += lanes) {
+    _mm_storeu_ps(xs + i,
+                  _mm_add_ps(_mm_loadu_ps(xs + i), _mm_loadu_ps(dxs + i)));
+    _mm_storeu_ps(ys + i,
+                  _mm_add_ps(_mm_loadu_ps(ys + i), _mm_loadu_ps(dys + i)));
+  }
+#endif
+
+  for (; i < count; i++) {
+    xs[i] += dxs[i];
+    ys[i] += dys[i];
+  }
+}
+
+void VectorBatch::Scale(float *xs, float *ys, float s, std::size_t count) {
+  std::size_t i = 0;
+
+#if defined(VECTOR_BATCH_AVX)
+  const __m256 factor = _mm256_set1_ps(s);
+  for (; i < simdEnd(count); i += lanes) {
+    _mm256_storeu_ps(xs + i, _mm256_mul_ps(_mm256_loadu_ps(xs + i), factor));
+    _mm256_storeu_ps(ys + i, _mm256_mul_ps(_mm256_loadu_ps(ys + i), factor));
+  }
+#elif defined(VECTOR_BATCH_SSE2)
+  const __m128 factor = _mm_set1_ps(s);
+  for (; i < simdEnd(count); i += lanes) {
+    _mm_storeu_ps(xs + i, _mm_mul_ps(_mm_loadu_ps(xs + i), factor));
+    _mm_storeu_ps(ys + i, _mm_mul_ps(_mm_loadu_ps(ys + i), factor));
+  }
+#endif
+
+  for (; i < count; i++) {
+    xs[i] *= s;
+    ys[i] *= s;
+  }
+}
+
+void VectorBatch::Length(const float *xs, const float *ys, float *out,
+                         std::size_t count) {
+  std::size_t i = 0;
+
+#if defined(VECTOR_BATCH_AVX)
+  for (; i < simdEnd(count); i += lanes) {
+    const __m256 x = _mm256_loadu_ps(xs + i);
+    const __m256 y = _mm256_loadu_ps(ys + i);
+    const __m256 squared =
+        _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y));
+    _mm256_storeu_ps(out + i, _mm256_sqrt_ps(squared));
+  }
+#elif defined(VECTOR_BATCH_SSE2)
+  for (; i < simdEnd(count); i += lanes) {
+    const __m128 x = _mm_loadu_ps(xs + i);
+    const __m128 y = _mm_loadu_ps(ys + i);
+    const __m128 squared = _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y));
+    _mm_storeu_ps(out + i, _mm_sqrt_ps(squared));
+  }
+#endif
+
+  for (; i < count; i++) {
+    const float squared = xs[i] * xs[i] + ys[i] * ys[i];
+    out[i] = std::sqrt(squared);
+  }
+}
+
+void VectorBatch::Normalize(float *xs, float *ys, std::size_t count) {
+  std::size_t i = 0;
+
+#if defined(VECTOR_BATCH_AVX)
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 one = _mm256_set1_ps(1.0f);
+  for (; i < simdEnd(count); i += lanes) {
+    const __m256 x = _mm256_loadu_ps(xs + i);
+    const __m256 y = _mm256_loadu_ps(ys + i);
+    const __m256 length = _mm256_sqrt_ps(
+        _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)));
+
+    // Divide zero-length lanes by one so they stay unchanged
+    const __m256 nonZero = _mm256_cmp_ps(length, zero, _CMP_GT_OQ);
+    const __m256 divisor = _mm256_blendv_ps(one, length, nonZero);
+
+    _mm256_storeu_ps(xs + i, _mm256_div_ps(x, divisor));
+    _mm256_storeu_ps(ys + i, _mm256_div_ps(y, divisor));
+  }
+#elif defined(VECTOR_BATCH_SSE2)
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  for (; i < simdEnd(count); i += lanes) {
+    const __m128 x = _mm_loadu_ps(xs + i);
+    const __m128 y = _mm_loadu_ps(ys + i);
+    const __m128 length =
+        _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)));
+
+    // Divide zero-length lanes by one so they stay unchanged
+    const __m128 nonZero = _mm_cmpgt_ps(length, zero);
+    const __m128 divisor =
+        _mm_or_ps(_mm_and_ps(nonZero, length), _mm_andnot_ps(nonZero, one));
+
+    _mm_storeu_ps(xs + i, _mm_div_ps(x, divisor));
+    _mm_storeu_ps(ys + i, _mm_div_ps(y, divisor));
+  }
+#endif
+
+  for (; i < count; i++) {
+    const float squared = xs[i] * xs[i] + ys[i] * ys[i];
+    const float length = std::sqrt(squared);
+    if (length > 0.0f) {
+      xs[i] /= length;
+      ys[i] /= length;
+    }
+  }
+}
+
+void VectorBatch::Integrate(float *xs, float *ys, const float *vxs,
+                            const float *vys, const float *speeds,
+                            std::size_t count) {
+  std::size_t i = 0;
+
+#if defined(VECTOR_BATCH_AVX)
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+  for (; i < simdEnd(count); i += lanes) {
+    const __m256 vx = _mm256_loadu_ps(vxs + i);
+    const __m256 vy = _mm256_loadu_ps(vys + i);
+    const __m256 speed = _mm256_loadu_ps(speeds + i);
+    const __m256 length = _mm256_sqrt_ps(
+        _mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)));
+    const __m256 nonZero = _mm256_cmp_ps(length, zero, _CMP_NEQ_OQ);
+
+    // |v / length|, or 1 so zero-length lanes move by speed * v
+    const __m256 nx = _mm256_blendv_ps(
+        one, _mm256_and_ps(_mm256_div_ps(vx, length), absMask), nonZero);
+    const __m256 ny = _mm256_blendv_ps(
+        one, _mm256_and_ps(_mm256_div_ps(vy, length), absMask), nonZero);
+
+    const __m256 dx = _mm256_mul_ps(_mm256_mul_ps(speed, vx), nx);
+    const __m256 dy = _mm256_mul_ps(_mm256_mul_ps(speed, vy), ny);
+    _mm256_storeu_ps(xs + i, _mm256_add_ps(_mm256_loadu_ps(xs + i), dx));
+    _mm256_storeu_ps(ys + i, _mm256_add_ps(_mm256_loadu_ps(ys + i), dy));
+  }
+#elif defined(VECTOR_BATCH_SSE2)
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+  for (; i < simdEnd(count); i += lanes) {
+    const __m128 vx = _mm_loadu_ps(vxs + i);
+    const __m128 vy = _mm_loadu_ps(vys + i);
+    const __m128 speed = _mm_loadu_ps(speeds + i);
+    const __m128 length =
+        _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)));
+    const __m128 nonZero = _mm_cmpneq_ps(length, zero);
+
+    // |v / length|, or 1 so zero-length lanes move by speed * v
+    const __m128 nx =
+        _mm_or_ps(_mm_and_ps(nonZero, _mm_and_ps(_mm_div_ps(vx, length), absMask)),
+                  _mm_andnot_ps(nonZero, one));
+    const __m128 ny =
+        _mm_or_ps(_mm_and_ps(nonZero, _mm_and_ps(_mm_div_ps(vy, length), absMask)),
+                  _mm_andnot_ps(nonZero, one));
+
+    const __m128 dx = _mm_mul_ps(_mm_mul_ps(speed, vx), nx);
+    const __m128 dy = _mm_mul_ps(_mm_mul_ps(speed, vy), ny);
+    _mm_storeu_ps(xs + i, _mm_add_ps(_mm_loadu_ps(xs + i), dx));
+    _mm_storeu_ps(ys + i, _mm_add_ps(_mm_loadu_ps(ys + i), dy));
+  }
+#endif
+
+  for (; i < count; i++) {
+    const float length = std::sqrt(vxs[i] * vxs[i] + vys[i] * vys[i]);
+    const float nx = length != 0.0f ? std::abs(vxs[i] / length) : 1.0f;
+    const float ny = length != 0.0f ? std::abs(vys[i] / length) : 1.0f;
+    xs[i] += (speeds[i] * vxs[i]) * nx;
+    ys[i] += (speeds[i] * vys[i]) * ny;
+  }
+}
+
+void VectorBatch::MulAdd(float *values, const float *rates, float s,
+                         std::size_t count) {
+  std::size_t i = 0;
+
+#if defined(VECTOR_BATCH_AVX)
+  const __m256 factor = _mm256_set1_ps(s);
+  for (; i < simdEnd(count); i += lanes) {
+    const __m256 delta = _mm256_mul_ps(_mm256_loadu_ps(rates + i), factor);
+    _mm256_storeu_ps(values + i,
+                     _mm256_add_ps(_mm256_loadu_ps(values + i), delta));
+  }
+#elif defined(VECTOR_BATCH_SSE2)
+  const __m128 factor = _mm_set1_ps(s);
+  for (; i < simdEnd(count); i += lanes) {
+    const __m128 delta = _mm_mul_ps(_mm_loadu_ps(rates + i), factor);
+    _mm_storeu_ps(values + i, _mm_add_ps(_mm_loadu_ps(values + i), delta));
+  }
+#endif
+
+  for (; i < count; i++) {
+    const float delta = rates[i] * s;
+    values[i] += delta;
+  }
+}
+
+void VectorBatch::Offset(float *values, float s, std::size_t count) {
+  std::size_t i = 0;
+
+#if defined(VECTOR_BATCH_AVX)
+  const __m256 offset = _mm256_set1_ps(s);
+  for (; i < simdEnd(count); i += lanes) {
+    _mm256_storeu_ps(values + i,
+                     _mm256_add_ps(_mm256_loadu_ps(values + i), offset));
+  }
+#elif defined(VECTOR_BATCH_SSE2)
+  const __m128 offset = _mm_set1_ps(s);
+  for (; i < simdEnd(count); i += lanes) {
+    _mm_storeu_ps(values + i, _mm_add_ps(_mm_loadu_ps(values + i), offset));
+  }
+#endif
+
+  for (; i < count; i++) {
+    values[i] += s;
+  }
+}
+
+const char *VectorBatch::InstructionSet() {
+#if defined(VECTOR_BATCH_AVX)
+  return "AVX";
+#elif defined(VECTOR_BATCH_SSE2)
+  return "SSE2";
+#else
+  return "scalar";
+#endif
+}
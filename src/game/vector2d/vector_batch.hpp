@@ -0,0 +1,52 @@
+#ifndef VECTOR_BATCH_HPP
+#define VECTOR_BATCH_HPP
+
+#include <cstddef>
+
+/**
+ * VectorBatch class
+ *
+ * Math kernels over arrays of 2D vectors stored as separate x and y arrays
+ * (structure of arrays). They use AVX when the build enables it, SSE2 on any
+ * x86-64 target and a scalar loop elsewhere; every path gives the same
+ * results since only correctly rounded operations are used.
+ *
+ * Input and output arrays may be the same array but must not partially
+ * overlap.
+ */
+class VectorBatch {
+public:
+  // xs += dxs, ys += dys
+  static void Add(float *xs, float *ys, const float *dxs, const float *dys,
+                  std::size_t count);
+
+  // xs *= s, ys *= s
+  static void Scale(float *xs, float *ys, float s, std::size_t count);
+
+  // out = sqrt(x * x + y * y)
+  static void Length(const float *xs, const float *ys, float *out,
+                     std::size_t count);
+
+  // Divide every non-zero vector by its length; zero vectors are left as is
+  static void Normalize(float *xs, float *ys, std::size_t count);
+
+  // Move positions by velocities scaled to `speeds` along the direction of
+  // travel, so diagonals are not faster:
+  //   x += (speed * vx) * |vx / length|   (speed * vx for a zero length)
+  // One square root per vector; the divisions are kept so the result is
+  // bit-identical to the per-axis TransformComponent math it replaces.
+  static void Integrate(float *xs, float *ys, const float *vxs,
+                        const float *vys, const float *speeds,
+                        std::size_t count);
+
+  // values += rates * s, rounded after the multiply (no fused multiply-add)
+  static void MulAdd(float *values, const float *rates, float s,
+                     std::size_t count);
+
+  // values += s
+  static void Offset(float *values, float s, std::size_t count);
+
+  static const char *InstructionSet(); // "AVX", "SSE2" or "scalar"
+};
+
+#endif
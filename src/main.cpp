@@ -1,8 +1,24 @@
 #include "game/game.hpp"
+#include "utility/allocTracker/alloc_tracker.hpp"
+#include "utility/utility.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 
 // Create a game object
 Game *game = nullptr;
 
+/**
+ * Command line:
+ *   --record <file>   Record the input of every tick
+ *   --replay <file>   Play a recording back instead of the live input
+ *   --headless        Hidden window, no vsync, no frame cap
+ *   --timings <file>  Write the duration of every frame, in ms, one per line
+ *   --strict-alloc    Fail on any heap allocation after the first frames
+ *   --pixel-scale <n> Draw the world at 1/n of the window and upscale it
+ *   --spawn <n>       Spawn n patrolling agents from a prefab, as a load test
+ */
 int main(int argc, char *argv[]) {
 
   // Set the FPS and frame delay
@@ -13,6 +29,46 @@ int main(int argc, char *argv[]) {
   Uint32 frameStart;
   int frameTime;
 
+  const char *recordPath = nullptr;
+  const char *replayPath = nullptr;
+  const char *timingsPath = nullptr;
+
+  for (int i = 1; i < argc; i++) {
+    const bool hasValue = i + 1 < argc;
+    if (std::strcmp(argv[i], "--record") == 0 && hasValue) {
+      recordPath = argv[++i];
+    } else if (std::strcmp(argv[i], "--replay") == 0 && hasValue) {
+      replayPath = argv[++i];
+    } else if (std::strcmp(argv[i], "--timings") == 0 && hasValue) {
+      timingsPath = argv[++i];
+    } else if (std::strcmp(argv[i], "--pixel-scale") == 0 && hasValue) {
+      Game::renderScale = std::max(std::atoi(argv[++i]), 1);
+    } else if (std::strcmp(argv[i], "--spawn") == 0 && hasValue) {
+      Game::spawnAgents = std::max(std::atoi(argv[++i]), 0);
+    } else if (std::strcmp(argv[i], "--headless") == 0) {
+      Game::headless = true;
+    } else if (std::strcmp(argv[i], "--strict-alloc") == 0) {
+      AllocTracker::SetStrict(true);
+    }
+  }
+
+  if (replayPath) {
+    if (!InputRecorder::StartReplay(replayPath)) {
+      return 1;
+    }
+  } else if (recordPath) {
+    InputRecorder::StartRecording(recordPath);
+  }
+
+  // Per-frame durations, kept in memory so writing them costs no frame time.
+  // Reserved for the whole replay, or ten minutes of a live run, so the loop
+  // does not allocate to record them.
+  std::vector<double> frameTimings;
+  if (timingsPath) {
+    frameTimings.reserve(replayPath ? InputRecorder::Length() + 1
+                                    : 10 * 60 * FPS);
+  }
+
   // Assign the game object to the game pointer
   game = new Game();
 
@@ -23,26 +79,47 @@ int main(int argc, char *argv[]) {
   while (game->running()) {
     // Get the frame start time
     frameStart = SDL_GetTicks();
+    const Uint64 frameCounter = SDL_GetPerformanceCounter();
 
-    // Handle events
+    // Handle events on the main thread, then simulate the next tick on the
+    // simulation thread while the previous one is rendered
     game->handleEvents();
+    if (!game->running()) {
+      break;
+    }
     game->update();
     game->render();
+    game->sync();
+
+    if (timingsPath) {
+      frameTimings.push_back(Utility::MsSince(frameCounter));
+    }
 
     // Get the frame time
     frameTime = SDL_GetTicks() - frameStart;
 
     // If the frame time is less than the frame delay, delay the game
-    if (frameDelay > frameTime) {
+    if (!Game::headless && frameDelay > frameTime) {
       SDL_Delay(frameDelay - frameTime);
     }
+
+    // Everything allocated since the previous frame ended, on any thread,
+    // the delay included
+    AllocTracker::EndFrame();
   }
 
   game->clean();
 
+  if (timingsPath) {
+    std::ofstream timings(timingsPath);
+    for (double ms : frameTimings) {
+      timings << ms << '\n';
+    }
+  }
+
   // Release the dynamically allocated Game instance
   delete game;
   game = nullptr;
 
   return 0;
-}
\ No newline at end of file
+}
@@ -1,39 +1,244 @@
 #include "texture_manager.hpp"
+#include "../assetPack/asset_pack.hpp"
 #include "../game/game.hpp"
-#include "../utility/utility.hpp"
+#include "../utility/allocTracker/alloc_tracker.hpp"
+#include "../utility/logger/logger.hpp"
+#include "../utility/threadPool/thread_pool.hpp"
 #include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// A surface decoded by a worker, waiting for its upload on the main thread
+struct DecodedImage {
+  TextureHandle handle;
+  SDL_Surface *surface;
+};
+
+// Shared between the workers and the threads requesting textures
+std::mutex registryMutex;
+std::condition_variable decodedCv;
+std::unordered_map<std::string, TextureHandle> pathToHandle;
+TextureHandle nextHandle = 1;
+std::vector<DecodedImage> decoded;
+std::size_t pendingDecodes = 0;
+
+// Owned by the main thread
+std::array<SDL_Texture *, maxTextures> textures{};
+SDL_Texture *placeholder = nullptr;
+std::size_t textureBytes = 0;
+
+std::unique_ptr<ThreadPool> decoders;
+
+SDL_Surface *decodeImage(const std::string &path) {
+  AllocScope allocScope(AllocTag::Assets);
+
+  // Pre-decoded pixels from the pack skip the PNG decode entirely
+  if (SDL_Surface *cooked = AssetPack::LoadSurface(path)) {
+    return cooked;
+  }
+
+  SDL_Surface *surface = IMG_Load(path.c_str());
+  if (!surface) {
+    LOG_ERROR("Failed to load texture %s: %s", path.c_str(), IMG_GetError());
+  }
+  return surface;
+}
+
+void publishDecoded(TextureHandle handle, SDL_Surface *surface) {
+  {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    decoded.push_back({handle, surface});
+    pendingDecodes--;
+  }
+  decodedCv.notify_all();
+}
+
+} // namespace
+
+/**
+ * Create the placeholder texture and start the decode workers.
+ * Must be called after the renderer has been created.
+ */
+void TextureManager::Init() {
+  // 1x1 transparent texture bound until the real one is uploaded
+  const Uint32 transparent = 0;
+  placeholder = SDL_CreateTexture(Game::renderer, SDL_PIXELFORMAT_RGBA32,
+                                  SDL_TEXTUREACCESS_STATIC, 1, 1);
+  if (placeholder) {
+    SDL_UpdateTexture(placeholder, nullptr, &transparent, sizeof(Uint32));
+    SDL_SetTextureBlendMode(placeholder, SDL_BLENDMODE_BLEND);
+  }
+
+  // Leave one core to the main thread and one to the simulation
+  const unsigned cores = std::thread::hardware_concurrency();
+  const unsigned workers = std::clamp(cores > 2 ? cores - 2 : 1u, 1u, 4u);
+  decoders = std::make_unique<ThreadPool>(workers);
+}
+
+/**
+ * Stop the decode workers and destroy every texture owned by the manager
+ */
+void TextureManager::Clean() {
+  decoders.reset(); // Joins the workers once the queued decodes are done
+
+  for (auto &image : decoded) {
+    if (image.surface) {
+      SDL_FreeSurface(image.surface);
+    }
+  }
+  decoded.clear();
+
+  for (auto &tex : textures) {
+    if (tex) {
+      SDL_DestroyTexture(tex);
+      tex = nullptr;
+    }
+  }
+
+  if (placeholder) {
+    SDL_DestroyTexture(placeholder);
+    placeholder = nullptr;
+  }
+
+  pathToHandle.clear();
+  nextHandle = 1;
+  textureBytes = 0;
+}
 
 /**
- * Load a texture from a file
+ * Request a texture without waiting for it.
+ * Safe to call from any thread. Repeated requests for the same path return
+ * the same handle and decode the file only once.
  *
  * @param texture The path to the texture file
- * @param ren The renderer to load the texture into
- * @return The loaded texture
+ * @return The handle of the texture, 0 if the table is full
  */
-SDL_Texture *TextureManager::LoadTexture(const char *texture) {
-  // Load the texture from the file
-  SDL_Surface *tempSurface = IMG_Load(texture);
+TextureHandle TextureManager::LoadTextureAsync(const char *texture) {
+  std::string path(texture);
+  TextureHandle handle;
 
-  // Check if the surface was loaded
-  if (!tempSurface) {
-    Utility::Log("Failed to load texture: " + std::string(texture));
-    Utility::Log("SDL_image Error: " + std::string(IMG_GetError()));
-    return nullptr;
+  {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto it = pathToHandle.find(path);
+    if (it != pathToHandle.end()) {
+      return it->second;
+    }
+
+    if (nextHandle >= maxTextures) {
+      LOG_ERROR("Texture table full, cannot load %s", path.c_str());
+      return 0;
+    }
+
+    handle = nextHandle++;
+    pathToHandle.emplace(path, handle);
+    pendingDecodes++;
+  }
+
+  if (!decoders) {
+    // No workers yet: decode inline, the upload still happens later
+    publishDecoded(handle, decodeImage(path));
+    return handle;
   }
 
-  // Create a texture from the surface
-  SDL_Texture *tex = SDL_CreateTextureFromSurface(Game::renderer, tempSurface);
-  // Free the surface now that we're done with it
-  SDL_FreeSurface(tempSurface);
+  decoders->submit([handle, path] { publishDecoded(handle, decodeImage(path)); });
+  return handle;
+}
+
+/**
+ * Upload decoded surfaces to the GPU until the time budget is spent.
+ * At least one upload is done per call so loading always progresses.
+ *
+ * @param budgetMs Time this call may spend, in milliseconds
+ */
+void TextureManager::ProcessUploads(double budgetMs) {
+  const Uint64 start = SDL_GetPerformanceCounter();
+  const double ticksPerMs =
+      static_cast<double>(SDL_GetPerformanceFrequency()) / 1000.0;
+
+  while (true) {
+    DecodedImage image;
+    {
+      std::lock_guard<std::mutex> lock(registryMutex);
+      if (decoded.empty()) {
+        return;
+      }
+      image = decoded.back();
+      decoded.pop_back();
+    }
+
+    if (image.surface) {
+      textures[image.handle] =
+          SDL_CreateTextureFromSurface(Game::renderer, image.surface);
+      SDL_FreeSurface(image.surface);
+
+      if (!textures[image.handle]) {
+        LOG_ERROR("Failed to create texture from surface: %s", SDL_GetError());
+      } else {
+        Uint32 format = 0;
+        int w = 0, h = 0;
+        SDL_QueryTexture(textures[image.handle], &format, nullptr, &w, &h);
+        textureBytes += static_cast<std::size_t>(w) * h *
+                        SDL_BYTESPERPIXEL(format);
+      }
+    }
+
+    const double elapsedMs = (SDL_GetPerformanceCounter() - start) / ticksPerMs;
+    if (elapsedMs >= budgetMs) {
+      return;
+    }
+  }
+}
 
-  // Check if the texture was created
-  if (!tex) {
-    Utility::Log("Failed to create texture from " + std::string(texture));
+/**
+ * Block until every requested texture has been decoded and uploaded
+ */
+void TextureManager::WaitForUploads() {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(registryMutex);
+      decodedCv.wait(lock,
+                     [] { return !decoded.empty() || pendingDecodes == 0; });
+      if (decoded.empty() && pendingDecodes == 0) {
+        return;
+      }
+    }
+
+    ProcessUploads(1000.0);
+  }
+}
+
+/**
+ * Resolve a handle to a texture
+ * @return The texture, the placeholder while it is loading, or nullptr for
+ * handle 0
+ */
+SDL_Texture *TextureManager::Get(TextureHandle handle) {
+  if (handle == 0 || handle >= maxTextures) {
     return nullptr;
   }
+  return textures[handle] ? textures[handle] : placeholder;
+}
 
-  // Return the texture
-  return tex;
+/**
+ * Whether every requested texture has been decoded and uploaded
+ */
+bool TextureManager::IsIdle() {
+  std::lock_guard<std::mutex> lock(registryMutex);
+  return pendingDecodes == 0 && decoded.empty();
+}
+
+std::size_t TextureManager::TextureBytes() { return textureBytes; }
+
+bool TextureManager::IsReady(TextureHandle handle) {
+  return handle != 0 && handle < maxTextures && textures[handle] != nullptr;
 }
 
 /**
@@ -54,4 +259,4 @@ void TextureManager::Draw(SDL_Texture *tex, SDL_Rect src, SDL_Rect dest,
   if (tex) {
     SDL_RenderCopyEx(Game::renderer, tex, &src, &dest, 0, NULL, flip);
   }
-}
\ No newline at end of file
+}
@@ -2,20 +2,44 @@
 #define texture_manager_hpp
 
 #include <SDL2/SDL.h>
+#include <cstdint>
+
+// Index of a texture owned by the TextureManager (0 = no texture)
+using TextureHandle = std::uint32_t;
+
+// Maximum number of distinct texture files we can handle
+constexpr std::size_t maxTextures = 1024;
 
 /**
  * TextureManager class
  *
  * This class is used to load and draw textures
  *
+ * Textures requested with LoadTextureAsync are decoded on worker threads and
+ * uploaded to the GPU on the main thread by ProcessUploads. Until then Get()
+ * returns a placeholder, so callers never wait on a decode. Textures are
+ * shared per path and owned by the manager.
+ *
  * @author: @iMeyu
  */
 class TextureManager {
 public:
-  static SDL_Texture *LoadTexture(const char *texture);
+  static void Init();  // Create the placeholder and the decode workers
+  static void Clean(); // Stop the workers and destroy every texture
+
+  static TextureHandle LoadTextureAsync(const char *texture);
+
+  static void ProcessUploads(double budgetMs); // Main thread only
+  static void WaitForUploads();                // Main thread only
+
+  static SDL_Texture *Get(TextureHandle handle); // Main thread only
+  static bool IsReady(TextureHandle handle);
+  static bool IsIdle();
+  static std::size_t TextureBytes(); // Pixels uploaded so far, main thread
+
   static void Draw(SDL_Texture *tex, SDL_Rect src, SDL_Rect dest);
   static void Draw(SDL_Texture *tex, SDL_Rect src, SDL_Rect dest,
                    SDL_RendererFlip flip);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,161 @@
+#include "alloc_tracker.hpp"
+#include "../logger/logger.hpp"
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <new>
+
+FrameAllocations AllocTracker::lastFrame;
+FrameAllocations AllocTracker::total;
+std::uint64_t AllocTracker::frames = 0;
+std::uint64_t AllocTracker::allocatingFrames = 0;
+std::uint32_t AllocTracker::warmup = 120;
+bool AllocTracker::strict = false;
+
+namespace {
+
+// Zero-initialised before any constructor runs, so allocations made during
+// static initialisation are counted too
+std::array<std::atomic<std::uint64_t>, allocTagCount> frameCount;
+std::array<std::atomic<std::uint64_t>, allocTagCount> frameBytes;
+
+thread_local AllocTag currentTag = AllocTag::Untagged;
+
+constexpr const char *tagNames[allocTagCount] = {
+    "untagged", "input",    "simulation", "ecs",    "collision",
+    "particles", "snapshot", "render",     "assets", "logging",
+    "behaviours"};
+
+} // namespace
+
+std::uint64_t FrameAllocations::totalCount() const {
+  std::uint64_t sum = 0;
+  for (std::uint64_t c : count) {
+    sum += c;
+  }
+  return sum;
+}
+
+std::uint64_t FrameAllocations::totalBytes() const {
+  std::uint64_t sum = 0;
+  for (std::uint64_t b : bytes) {
+    sum += b;
+  }
+  return sum;
+}
+
+bool AllocTracker::Enabled() {
+#ifdef GAME_ALLOC_TRACKING
+  return true;
+#else
+  return false;
+#endif
+}
+
+void AllocTracker::SetStrict(bool enable, std::uint32_t warmupFrames) {
+  strict = enable;
+  warmup = warmupFrames;
+}
+
+/**
+ * Close the frame: it is charged with everything allocated since the
+ * previous EndFrame, on any thread, so nothing falls between two frames.
+ * The first frame also holds the loading.
+ */
+void AllocTracker::EndFrame() {
+  for (std::size_t i = 0; i < allocTagCount; i++) {
+    lastFrame.count[i] = frameCount[i].exchange(0, std::memory_order_relaxed);
+    lastFrame.bytes[i] = frameBytes[i].exchange(0, std::memory_order_relaxed);
+    total.count[i] += lastFrame.count[i];
+    total.bytes[i] += lastFrame.bytes[i];
+  }
+  frames++;
+
+  if (frames <= warmup || lastFrame.totalCount() == 0) {
+    return;
+  }
+  allocatingFrames++;
+
+  if (strict) {
+    for (std::size_t i = 0; i < allocTagCount; i++) {
+      if (lastFrame.count[i] > 0) {
+        LOG_ERROR("Frame %llu: %llu allocations (%llu bytes) in %s",
+                  static_cast<unsigned long long>(frames),
+                  static_cast<unsigned long long>(lastFrame.count[i]),
+                  static_cast<unsigned long long>(lastFrame.bytes[i]),
+                  tagNames[i]);
+      }
+    }
+    assert(lastFrame.totalCount() == 0 && "Steady-state frame allocated");
+  }
+}
+
+void AllocTracker::Report() {
+  if (!Enabled()) {
+    LOG_INFO("Allocation tracking not built in");
+    return;
+  }
+
+  LOG_INFO("Allocations over %llu frames: %llu frames allocated after the "
+           "first %u",
+           static_cast<unsigned long long>(frames),
+           static_cast<unsigned long long>(allocatingFrames), warmup);
+  for (std::size_t i = 0; i < allocTagCount; i++) {
+    if (total.count[i] > 0) {
+      LOG_INFO("  %-10s %10llu allocations %12llu bytes", tagNames[i],
+               static_cast<unsigned long long>(total.count[i]),
+               static_cast<unsigned long long>(total.bytes[i]));
+    }
+  }
+}
+
+void AllocTracker::Record(std::size_t bytes) {
+  const auto tag = static_cast<std::size_t>(currentTag);
+  frameCount[tag].fetch_add(1, std::memory_order_relaxed);
+  frameBytes[tag].fetch_add(bytes, std::memory_order_relaxed);
+}
+
+AllocTag AllocTracker::SwapTag(AllocTag tag) {
+  const AllocTag previous = currentTag;
+  currentTag = tag;
+  return previous;
+}
+
+const char *AllocTracker::TagName(AllocTag tag) {
+  return tagNames[static_cast<std::size_t>(tag)];
+}
+
+#ifdef GAME_ALLOC_TRACKING
+
+// Replacements of the global allocation functions. The aligned overloads
+// keep the library versions and are not counted.
+
+void *operator new(std::size_t size) {
+  AllocTracker::Record(size);
+  if (void *p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) { return operator new(size); }
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  AllocTracker::Record(size);
+  return std::malloc(size ? size : 1);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &tag) noexcept {
+  return operator new(size, tag);
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept {
+  std::free(p);
+}
+
+#endif
@@ -0,0 +1,96 @@
+// alloc_tracker.hpp
+// Heap allocation counters.
+// With GAME_ALLOC_TRACKING defined the global operator new is replaced by
+// one that counts every allocation, and its bytes, against the tag of the
+// calling thread. The main loop ends each frame with EndFrame, which takes
+// the counters since the previous one; tagged scopes say which subsystem
+// allocated.
+#ifndef ALLOC_TRACKER_HPP
+#define ALLOC_TRACKER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Subsystem an allocation is charged to
+enum class AllocTag : std::uint8_t {
+  Untagged,
+  Input,
+  Simulation,
+  ECS,
+  Collision,
+  Particles,
+  Snapshot,
+  Render,
+  Assets,
+  Logging,
+  Behaviours,
+  Count,
+};
+
+constexpr std::size_t allocTagCount = static_cast<std::size_t>(AllocTag::Count);
+
+/**
+ * Allocations of one frame, per tag
+ */
+struct FrameAllocations {
+  std::array<std::uint64_t, allocTagCount> count{};
+  std::array<std::uint64_t, allocTagCount> bytes{};
+
+  std::uint64_t totalCount() const;
+  std::uint64_t totalBytes() const;
+};
+
+/**
+ * AllocTracker class
+ *
+ * Counters are atomics updated from any thread; EndFrame and the queries
+ * belong to the main thread.
+ *
+ * In strict mode every frame after the warm-up must allocate nothing: one
+ * that does is logged with its tags, then fails an assertion.
+ *
+ * @author: @iMeyu
+ */
+class AllocTracker {
+public:
+  static bool Enabled(); // Built with the operator new hooks
+
+  static void SetStrict(bool strict, std::uint32_t warmupFrames = 120);
+
+  static void EndFrame(); // Once per frame, at the end of the loop body
+
+  static const FrameAllocations &LastFrame() { return lastFrame; }
+  static void Report(); // Log the totals since start
+
+  static void Record(std::size_t bytes); // From operator new
+  static AllocTag SwapTag(AllocTag tag); // Returns the previous tag
+
+  static const char *TagName(AllocTag tag);
+
+private:
+  static FrameAllocations lastFrame;
+  static FrameAllocations total;
+  static std::uint64_t frames;
+  static std::uint64_t allocatingFrames; // After the warm-up
+  static std::uint32_t warmup;
+  static bool strict;
+};
+
+/**
+ * Charges the allocations of the current thread to a tag until the end of
+ * the scope
+ */
+class AllocScope {
+public:
+  explicit AllocScope(AllocTag tag) : previous(AllocTracker::SwapTag(tag)) {}
+  ~AllocScope() { AllocTracker::SwapTag(previous); }
+
+  AllocScope(const AllocScope &) = delete;
+  AllocScope &operator=(const AllocScope &) = delete;
+
+private:
+  AllocTag previous;
+};
+
+#endif
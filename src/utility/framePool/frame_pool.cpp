@@ -0,0 +1,76 @@
+#include "frame_pool.hpp"
+#include <new>
+
+namespace {
+
+constexpr std::size_t smallestClass = 64;
+constexpr std::size_t classCount = 7; // 64 B to 4 KiB
+constexpr std::size_t framesPerChunk = 32;
+
+// A free frame holds the link to the next one
+struct FreeFrame {
+  FreeFrame *next;
+};
+
+// Plain pointers and counters: nothing here has a destructor to run
+FreeFrame *freeLists[classCount] = {};
+std::size_t bytesReserved = 0;
+
+// Size class of a request, classCount if it is too large
+std::size_t classOf(std::size_t size) {
+  std::size_t c = 0;
+  std::size_t classSize = smallestClass;
+  while (classSize < size && c < classCount) {
+    classSize <<= 1;
+    c++;
+  }
+  return c;
+}
+
+void refill(std::size_t c) {
+  const std::size_t classSize = smallestClass << c;
+  auto *chunk = static_cast<unsigned char *>(
+      ::operator new(classSize * framesPerChunk));
+  bytesReserved += classSize * framesPerChunk;
+
+  // Linked in address order, so frames are handed out front to back
+  for (std::size_t i = framesPerChunk; i-- > 0;) {
+    auto *frame = reinterpret_cast<FreeFrame *>(chunk + i * classSize);
+    frame->next = freeLists[c];
+    freeLists[c] = frame;
+  }
+}
+
+} // namespace
+
+void *FramePool::Allocate(std::size_t size) {
+  const std::size_t c = classOf(size);
+  if (c == classCount) {
+    return ::operator new(size);
+  }
+
+  if (!freeLists[c]) {
+    refill(c);
+  }
+  FreeFrame *frame = freeLists[c];
+  freeLists[c] = frame->next;
+  return frame;
+}
+
+void FramePool::Free(void *frame, std::size_t size) {
+  if (!frame) {
+    return;
+  }
+
+  const std::size_t c = classOf(size);
+  if (c == classCount) {
+    ::operator delete(frame);
+    return;
+  }
+
+  auto *free = static_cast<FreeFrame *>(frame);
+  free->next = freeLists[c];
+  freeLists[c] = free;
+}
+
+std::size_t FramePool::BytesReserved() { return bytesReserved; }
@@ -0,0 +1,31 @@
+#ifndef FRAME_POOL_HPP
+#define FRAME_POOL_HPP
+
+#include <cstddef>
+
+/**
+ * FramePool class
+ *
+ * Allocator for coroutine frames. Requests are rounded up to a power of two
+ * size class, from 64 bytes to 4 KiB, and served from a free list per class.
+ * An empty list is refilled with a chunk of frames at once, so starting and
+ * ending behaviours allocates nothing once their sizes have been seen.
+ * Larger frames go to the global allocator.
+ *
+ * Chunks are never returned: the free lists outlive every static, since
+ * frames may be released from destructors that run during static
+ * destruction.
+ *
+ * Not thread safe: behaviours live on the simulation thread.
+ *
+ * @author: @iMeyu
+ */
+class FramePool {
+public:
+  static void *Allocate(std::size_t size);
+  static void Free(void *frame, std::size_t size);
+
+  static std::size_t BytesReserved(); // Held in chunks, in use or free
+};
+
+#endif
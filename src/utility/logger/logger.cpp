@@ -0,0 +1,336 @@
+#include "logger.hpp"
+#include "../allocTracker/alloc_tracker.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t ringSlots = 512; // Messages buffered per thread
+constexpr std::size_t textSize = 240;  // Longer messages are truncated
+constexpr std::uint32_t maxPerSecond = 20; // Per call site
+constexpr auto flushInterval = std::chrono::milliseconds(10);
+
+struct Slot {
+  LogLevel level;
+  std::uint32_t timeMs;
+  std::uint32_t length;
+  char text[textSize];
+};
+
+/**
+ * Single-producer single-consumer ring: the owning thread writes head, the
+ * writer thread writes tail.
+ */
+struct ThreadRing {
+  std::array<Slot, ringSlots> slots;
+  alignas(64) std::atomic<std::uint64_t> head{0};
+  alignas(64) std::atomic<std::uint64_t> tail{0};
+};
+
+const auto startTime = std::chrono::steady_clock::now();
+
+// Rings are never freed: threads keep a pointer to theirs until they exit
+std::mutex ringsMutex;
+std::vector<std::unique_ptr<ThreadRing>> rings;
+
+std::atomic<bool> running{false};
+std::atomic<std::uint64_t> dropped{0};
+
+// Sites that suppressed a message at least once; only ever pushed to
+std::atomic<LogSite *> suppressingSites{nullptr};
+
+std::thread writer;
+std::mutex wakeMutex;
+std::condition_variable wakeCv;
+bool stopRequested = false;
+std::FILE *output = nullptr;
+
+std::uint32_t nowMs() {
+  return static_cast<std::uint32_t>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::steady_clock::now() - startTime)
+          .count());
+}
+
+const char *levelName(LogLevel level) {
+  switch (level) {
+  case LogLevel::Trace:
+    return "TRACE";
+  case LogLevel::Debug:
+    return "DEBUG";
+  case LogLevel::Info:
+    return "INFO";
+  case LogLevel::Warning:
+    return "WARN";
+  case LogLevel::Error:
+    return "ERROR";
+  }
+  return "?";
+}
+
+ThreadRing &threadRing() {
+  thread_local ThreadRing *ring = nullptr;
+  if (!ring) {
+    auto owned = std::make_unique<ThreadRing>();
+    ring = owned.get();
+    std::lock_guard<std::mutex> lock(ringsMutex);
+    rings.push_back(std::move(owned));
+  }
+  return *ring;
+}
+
+// Append one formatted line to the batch
+void appendLine(std::string &batch, LogLevel level, std::uint32_t timeMs,
+                const char *text, std::size_t length) {
+  char prefix[32];
+  const int prefixLength =
+      std::snprintf(prefix, sizeof(prefix), "[%5u.%03u] [%s] ", timeMs / 1000,
+                    timeMs % 1000, levelName(level));
+  batch.append(prefix, static_cast<std::size_t>(prefixLength));
+  batch.append(text, length);
+  batch.push_back('\n');
+}
+
+void drainRings(std::string &batch) {
+  std::lock_guard<std::mutex> lock(ringsMutex);
+
+  for (auto &ring : rings) {
+    std::uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+    const std::uint64_t head = ring->head.load(std::memory_order_acquire);
+
+    for (; tail < head; tail++) {
+      const Slot &slot = ring->slots[tail % ringSlots];
+      appendLine(batch, slot.level, slot.timeMs, slot.text, slot.length);
+    }
+
+    ring->tail.store(tail, std::memory_order_release);
+  }
+}
+
+// Whether the window opened at start is over at timeMs. A start stored by
+// another thread may be a little after timeMs: the signed difference keeps
+// that inside the window instead of wrapping around.
+bool windowOver(std::uint32_t start, std::uint32_t timeMs) {
+  return static_cast<std::int32_t>(timeMs - start) >= 1000;
+}
+
+// Report the messages of sites whose window ended without them logging
+// again, or of every site when the writer stops
+void flushSuppressed(std::string &batch, std::uint32_t timeMs, bool all) {
+  for (LogSite *site = suppressingSites.load(std::memory_order_acquire); site;
+       site = site->next) {
+    if (site->suppressed.load(std::memory_order_relaxed) == 0 ||
+        (!all && !windowOver(
+                     site->windowStart.load(std::memory_order_relaxed),
+                     timeMs))) {
+      continue;
+    }
+    // The site itself may take the count first when it logs again
+    const std::uint32_t count =
+        site->suppressed.exchange(0, std::memory_order_relaxed);
+    if (count == 0) {
+      continue;
+    }
+    char text[textSize];
+    const int length = std::snprintf(
+        text, sizeof(text), "(%u similar messages suppressed: %s)", count,
+        site->format);
+    if (length > 0) {
+      appendLine(batch, site->level, timeMs, text,
+                 std::min(static_cast<std::size_t>(length), textSize - 1));
+    }
+  }
+}
+
+void writerLoop() {
+  AllocScope allocScope(AllocTag::Logging);
+
+  std::string batch;
+  batch.reserve(64 * 1024);
+
+  while (true) {
+    bool stopping;
+    {
+      std::unique_lock<std::mutex> lock(wakeMutex);
+      wakeCv.wait_for(lock, flushInterval, [] { return stopRequested; });
+      stopping = stopRequested;
+    }
+
+    drainRings(batch);
+    flushSuppressed(batch, nowMs(), stopping);
+
+    if (!batch.empty()) {
+      std::fwrite(batch.data(), 1, batch.size(), output);
+      std::fflush(output);
+      batch.clear();
+    }
+
+    if (stopping) {
+      return;
+    }
+  }
+}
+
+/**
+ * Whether this call site may log now. Each site gets maxPerSecond messages
+ * per one-second window. The number dropped is reported by the call that
+ * opens the next window, or by the writer thread if none comes.
+ */
+bool allowed(LogSite &site, LogLevel level, const char *format,
+             std::uint32_t timeMs, std::uint32_t &suppressed) {
+  std::uint32_t windowStart = site.windowStart.load(std::memory_order_relaxed);
+
+  // Only the thread that moves the window resets it
+  if (windowOver(windowStart, timeMs) &&
+      site.windowStart.compare_exchange_strong(windowStart, timeMs,
+                                               std::memory_order_relaxed)) {
+    site.count.store(0, std::memory_order_relaxed);
+    suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+  }
+
+  if (site.count.fetch_add(1, std::memory_order_relaxed) < maxPerSecond) {
+    return true;
+  }
+
+  site.suppressed.fetch_add(1, std::memory_order_relaxed);
+  if (!site.listed.exchange(true, std::memory_order_relaxed)) {
+    site.level = level;
+    site.format = format;
+    site.next = suppressingSites.load(std::memory_order_relaxed);
+    while (!suppressingSites.compare_exchange_weak(
+        site.next, &site, std::memory_order_release,
+        std::memory_order_relaxed)) {
+    }
+  }
+  return false;
+}
+
+void push(LogLevel level, std::uint32_t timeMs, const char *format,
+          va_list args) {
+  if (!running.load(std::memory_order_acquire)) {
+    // No writer thread: write synchronously
+    char text[textSize];
+    const int length = std::vsnprintf(text, sizeof(text), format, args);
+    if (length < 0) {
+      return;
+    }
+    std::string line;
+    appendLine(line, level, timeMs, text,
+               std::min(static_cast<std::size_t>(length), textSize - 1));
+    std::fputs(line.c_str(), stdout);
+    return;
+  }
+
+  ThreadRing &ring = threadRing();
+  const std::uint64_t head = ring.head.load(std::memory_order_relaxed);
+  const std::uint64_t tail = ring.tail.load(std::memory_order_acquire);
+
+  // Never block the caller: drop the message when the ring is full
+  if (head - tail >= ringSlots) {
+    dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  Slot &slot = ring.slots[head % ringSlots];
+  const int length = std::vsnprintf(slot.text, textSize, format, args);
+  if (length < 0) {
+    return;
+  }
+  slot.level = level;
+  slot.timeMs = timeMs;
+  slot.length = static_cast<std::uint32_t>(
+      std::min(static_cast<std::size_t>(length), textSize - 1));
+
+  ring.head.store(head + 1, std::memory_order_release);
+}
+
+void pushf(LogLevel level, std::uint32_t timeMs, const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  push(level, timeMs, format, args);
+  va_end(args);
+}
+
+} // namespace
+
+/**
+ * Start the writer thread
+ * @param filePath File to append the log to, nullptr for stdout
+ */
+void Logger::Init(const char *filePath) {
+  if (running.load()) {
+    return;
+  }
+
+  output = stdout;
+  if (filePath) {
+    if (std::FILE *file = std::fopen(filePath, "a")) {
+      output = file;
+    }
+  }
+
+  stopRequested = false;
+  writer = std::thread(writerLoop);
+  running.store(true, std::memory_order_release);
+}
+
+/**
+ * Stop the writer thread after it has written everything buffered.
+ * Later messages are written synchronously.
+ */
+void Logger::Shutdown() {
+  if (!running.exchange(false)) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(wakeMutex);
+    stopRequested = true;
+  }
+  wakeCv.notify_one();
+  writer.join();
+
+  if (dropped.load() > 0) {
+    std::fprintf(output, "[LOG] %llu messages dropped (buffer full)\n",
+                 static_cast<unsigned long long>(dropped.load()));
+  }
+
+  if (output != stdout) {
+    std::fclose(output);
+  }
+  output = nullptr;
+}
+
+/**
+ * Queue a printf-style message
+ */
+void Logger::Write(LogLevel level, LogSite *site, const char *format, ...) {
+  const std::uint32_t timeMs = nowMs();
+
+  if (site) {
+    std::uint32_t suppressed = 0;
+    const bool ok = allowed(*site, level, format, timeMs, suppressed);
+    if (suppressed > 0) {
+      pushf(level, timeMs, "(%u similar messages suppressed)", suppressed);
+    }
+    if (!ok) {
+      return;
+    }
+  }
+
+  va_list args;
+  va_start(args, format);
+  push(level, timeMs, format, args);
+  va_end(args);
+}
+
+std::uint64_t Logger::Dropped() { return dropped.load(); }
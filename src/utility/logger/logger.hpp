@@ -0,0 +1,87 @@
+// logger.hpp
+// Asynchronous logger.
+// Messages are formatted by the calling thread into its own lock-free ring
+// buffer; a background thread drains every ring and writes in batches, so a
+// log call never waits on terminal or file I/O.
+//
+// Use the LOG_* macros: levels below GAME_LOG_LEVEL are compiled out and
+// their arguments never evaluated, and each call site is rate limited.
+#ifndef LOGGER_HPP
+#define LOGGER_HPP
+
+#include <atomic>
+#include <cstdint>
+
+enum class LogLevel : int {
+  Trace = 0,
+  Debug = 1,
+  Info = 2,
+  Warning = 3,
+  Error = 4,
+};
+
+// Minimum level compiled in
+#ifndef GAME_LOG_LEVEL
+#ifdef NDEBUG
+#define GAME_LOG_LEVEL 2
+#else
+#define GAME_LOG_LEVEL 1
+#endif
+#endif
+
+#if defined(__GNUC__)
+#define GAME_LOG_PRINTF(fmt, args) __attribute__((format(printf, fmt, args)))
+#else
+#define GAME_LOG_PRINTF(fmt, args)
+#endif
+
+/**
+ * Per call site state used to rate limit repeated messages. A site that
+ * suppressed something is linked, once, into a list the writer thread
+ * reports from when the site does not log again.
+ */
+struct LogSite {
+  std::atomic<std::uint32_t> windowStart{0}; // Same clock as the messages
+  std::atomic<std::uint32_t> count{0};
+  std::atomic<std::uint32_t> suppressed{0};
+
+  // Set before the site is linked, read by the writer thread
+  std::atomic<bool> listed{false};
+  LogSite *next = nullptr;
+  LogLevel level = LogLevel::Info;
+  const char *format = nullptr;
+};
+
+/**
+ * Logger class
+ *
+ * Before Init() and after Shutdown() messages are written synchronously.
+ */
+class Logger {
+public:
+  // Start the writer thread. Output goes to stdout when filePath is nullptr.
+  static void Init(const char *filePath = nullptr);
+  static void Shutdown(); // Drain every buffer and stop the writer thread
+
+  // site may be nullptr to bypass rate limiting
+  static void Write(LogLevel level, LogSite *site, const char *format, ...)
+      GAME_LOG_PRINTF(3, 4);
+
+  static std::uint64_t Dropped(); // Messages lost to full buffers
+};
+
+#define GAME_LOG(level, ...)                                                   \
+  do {                                                                         \
+    if constexpr (static_cast<int>(level) >= GAME_LOG_LEVEL) {                 \
+      static LogSite gameLogSite;                                              \
+      Logger::Write(level, &gameLogSite, __VA_ARGS__);                         \
+    }                                                                          \
+  } while (0)
+
+#define LOG_TRACE(...) GAME_LOG(LogLevel::Trace, __VA_ARGS__)
+#define LOG_DEBUG(...) GAME_LOG(LogLevel::Debug, __VA_ARGS__)
+#define LOG_INFO(...) GAME_LOG(LogLevel::Info, __VA_ARGS__)
+#define LOG_WARNING(...) GAME_LOG(LogLevel::Warning, __VA_ARGS__)
+#define LOG_ERROR(...) GAME_LOG(LogLevel::Error, __VA_ARGS__)
+
+#endif
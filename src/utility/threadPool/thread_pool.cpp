@@ -0,0 +1,45 @@
+#include "thread_pool.hpp"
+
+ThreadPool::ThreadPool(std::size_t threadCount) {
+  if (threadCount == 0) {
+    threadCount = 1;
+  }
+
+  workers.reserve(threadCount);
+  for (std::size_t i = 0; i < threadCount; i++) {
+    workers.emplace_back(&ThreadPool::workerLoop, this);
+  }
+}
+
+/**
+ * Finish the queued jobs, then join every worker
+ */
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  cv.notify_all();
+
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+void ThreadPool::workerLoop() {
+  while (true) {
+    std::function<void()> job;
+
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [this] { return stopping || !jobs.empty(); });
+      if (jobs.empty()) {
+        return; // Stopping and nothing left to do
+      }
+      job = std::move(jobs.front());
+      jobs.pop_front();
+    }
+
+    job();
+  }
+}
@@ -0,0 +1,58 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * ThreadPool class
+ *
+ * Fixed set of worker threads consuming a FIFO job queue.
+ * Used for work that must stay off the main thread (e.g. image decoding).
+ */
+class ThreadPool {
+public:
+  explicit ThreadPool(std::size_t threadCount);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /**
+   * Queue a job on the pool.
+   * @return A future holding the job result
+   */
+  template <typename F> auto submit(F &&job) -> std::future<decltype(job())> {
+    using Result = decltype(job());
+    auto task =
+        std::make_shared<std::packaged_task<Result()>>(std::forward<F>(job));
+    std::future<Result> result = task->get_future();
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      jobs.emplace_back([task] { (*task)(); });
+    }
+    cv.notify_one();
+
+    return result;
+  }
+
+  std::size_t size() const { return workers.size(); }
+
+private:
+  std::vector<std::thread> workers;
+  std::deque<std::function<void()>> jobs;
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool stopping = false;
+
+  void workerLoop();
+};
+
+#endif
@@ -1,8 +1,22 @@
 #include "utility.hpp"
+#include "logger/logger.hpp"
 
 Utility::Utility() {}
 Utility::~Utility() {}
 
+/**
+ * Log an info message through the asynchronous Logger.
+ * Prefer the LOG_* macros, which are filtered at compile time and rate
+ * limited per call site.
+ */
 void Utility::Log(const std::string &message) {
-  std::cout << message << std::endl;
-}
\ No newline at end of file
+  Logger::Write(LogLevel::Info, nullptr, "%s", message.c_str());
+}
+double Utility::MsBetween(Uint64 start, Uint64 end) {
+  return static_cast<double>(end - start) * 1000.0 /
+         static_cast<double>(SDL_GetPerformanceFrequency());
+}
+
+double Utility::MsSince(Uint64 start) {
+  return MsBetween(start, SDL_GetPerformanceCounter());
+}
@@ -1,6 +1,7 @@
 #ifndef UTILITY_HPP
 #define UTILITY_HPP
 
+#include <SDL2/SDL.h>
 #include <iostream>
 #include <string>
 
@@ -10,5 +11,10 @@ public:
   ~Utility();
 
   static void Log(const std::string &message);
+
+  // Milliseconds between two SDL_GetPerformanceCounter() values, or from one
+  // until now
+  static double MsBetween(Uint64 start, Uint64 end);
+  static double MsSince(Uint64 start);
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,265 @@
+// asset_cooker.cpp
+// Offline cook step: packs the assets directory into a single indexed file
+// that the game memory maps at startup (see src/assetPack).
+//
+// Usage: AssetCooker <assets dir> <output pack> [--lz4] [--bench]
+//
+// PNG files are decoded once here and stored as RGBA32 pixels, so the game
+// never runs zlib inflate at load time. --bench times loading every texture
+// from the loose PNGs and from the freshly written pack.
+#include "assetPack/asset_pack.hpp"
+#include "assetPack/asset_pack_format.hpp"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <lz4.h>
+#include <lz4hc.h>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct CookedAsset {
+  PackEntry entry;
+  std::vector<char> blob;
+};
+
+bool isPng(const fs::path &path) {
+  std::string ext = path.extension().string();
+  std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+  return ext == ".png";
+}
+
+// Name the game uses to load the asset, e.g. "assets/maps/lvl1.map"
+std::string runtimeName(const fs::path &root, const fs::path &file) {
+  return (fs::path("assets") / fs::relative(file, root)).generic_string();
+}
+
+void compress(CookedAsset &asset, const std::vector<char> &raw) {
+  std::vector<char> packed(LZ4_compressBound(static_cast<int>(raw.size())));
+  const int size =
+      LZ4_compress_HC(raw.data(), packed.data(), static_cast<int>(raw.size()),
+                      static_cast<int>(packed.size()), LZ4HC_CLEVEL_MAX);
+
+  // Keep the raw bytes when compression does not pay off
+  if (size <= 0 || static_cast<std::size_t>(size) >= raw.size()) {
+    asset.blob = raw;
+    return;
+  }
+
+  packed.resize(size);
+  asset.blob = std::move(packed);
+  asset.entry.compression = PackCompression::LZ4;
+}
+
+bool cookTexture(const fs::path &file, CookedAsset &asset, bool useLz4) {
+  SDL_Surface *loaded = IMG_Load(file.string().c_str());
+  if (!loaded) {
+    std::cerr << "Failed to load " << file << ": " << IMG_GetError() << "\n";
+    return false;
+  }
+
+  SDL_Surface *rgba =
+      SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+  SDL_FreeSurface(loaded);
+  if (!rgba) {
+    std::cerr << "Failed to convert " << file << ": " << SDL_GetError() << "\n";
+    return false;
+  }
+
+  const std::size_t rowBytes = static_cast<std::size_t>(rgba->w) * 4;
+  std::vector<char> pixels(rowBytes * rgba->h);
+  for (int y = 0; y < rgba->h; y++) {
+    std::memcpy(pixels.data() + y * rowBytes,
+                static_cast<char *>(rgba->pixels) + y * rgba->pitch, rowBytes);
+  }
+
+  asset.entry.type = PackEntryType::Texture;
+  asset.entry.width = static_cast<std::uint32_t>(rgba->w);
+  asset.entry.height = static_cast<std::uint32_t>(rgba->h);
+  asset.entry.rawSize = pixels.size();
+  SDL_FreeSurface(rgba);
+
+  if (useLz4) {
+    compress(asset, pixels);
+  } else {
+    asset.blob = std::move(pixels);
+  }
+  return true;
+}
+
+bool cookRaw(const fs::path &file, CookedAsset &asset) {
+  std::ifstream in(file, std::ios::binary);
+  if (!in) {
+    std::cerr << "Failed to open " << file << "\n";
+    return false;
+  }
+
+  asset.blob.assign(std::istreambuf_iterator<char>(in),
+                    std::istreambuf_iterator<char>());
+  asset.entry.type = PackEntryType::Raw;
+  asset.entry.rawSize = asset.blob.size();
+  return true;
+}
+
+std::uint64_t align(std::uint64_t offset) {
+  return (offset + packAlignment - 1) / packAlignment * packAlignment;
+}
+
+bool writePack(const std::string &path, std::vector<CookedAsset> &assets) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    std::cerr << "Failed to create " << path << "\n";
+    return false;
+  }
+
+  PackHeader header{};
+  std::memcpy(header.magic, packMagic, sizeof(packMagic));
+  header.version = packVersion;
+  header.entryCount = static_cast<std::uint32_t>(assets.size());
+
+  std::uint64_t offset = align(sizeof(PackHeader));
+  for (auto &asset : assets) {
+    asset.entry.offset = offset;
+    asset.entry.size = asset.blob.size();
+    offset = align(offset + asset.blob.size());
+  }
+  header.tocOffset = offset;
+
+  const char padding[packAlignment] = {};
+  auto pad = [&](std::uint64_t written) {
+    out.write(padding, static_cast<std::streamsize>(align(written) - written));
+  };
+
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  pad(sizeof(header));
+  for (const auto &asset : assets) {
+    out.write(asset.blob.data(), static_cast<std::streamsize>(asset.blob.size()));
+    pad(asset.entry.offset + asset.blob.size());
+  }
+  for (const auto &asset : assets) {
+    out.write(reinterpret_cast<const char *>(&asset.entry), sizeof(PackEntry));
+  }
+
+  return static_cast<bool>(out);
+}
+
+double msSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// Load every texture both ways and report the time spent
+void bench(const std::vector<fs::path> &pngs, const std::vector<std::string> &names,
+           const std::string &packPath) {
+  auto start = std::chrono::steady_clock::now();
+  for (const auto &png : pngs) {
+    if (SDL_Surface *surface = IMG_Load(png.string().c_str())) {
+      SDL_FreeSurface(surface);
+    }
+  }
+  const double looseMs = msSince(start);
+
+  start = std::chrono::steady_clock::now();
+  if (!AssetPack::Open(packPath.c_str())) {
+    std::cerr << "Failed to open " << packPath << " for benchmarking\n";
+    return;
+  }
+  for (const auto &name : names) {
+    if (SDL_Surface *surface = AssetPack::LoadSurface(name)) {
+      SDL_FreeSurface(surface);
+    }
+  }
+  const double packMs = msSince(start);
+  AssetPack::Close();
+
+  std::cout << "Texture load: loose PNG " << looseMs << " ms, pack " << packMs
+            << " ms (" << pngs.size() << " textures)\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    std::cerr << "Usage: AssetCooker <assets dir> <output pack> [--lz4] "
+                 "[--bench]\n";
+    return 1;
+  }
+
+  const fs::path root(argv[1]);
+  const std::string output(argv[2]);
+  bool useLz4 = false;
+  bool runBench = false;
+  for (int i = 3; i < argc; i++) {
+    useLz4 = useLz4 || std::strcmp(argv[i], "--lz4") == 0;
+    runBench = runBench || std::strcmp(argv[i], "--bench") == 0;
+  }
+
+  IMG_Init(IMG_INIT_PNG);
+
+  // Sort the files so the pack is identical between runs
+  std::vector<fs::path> files;
+  for (const auto &item : fs::recursive_directory_iterator(root)) {
+    if (item.is_regular_file()) {
+      files.push_back(item.path());
+    }
+  }
+  std::sort(files.begin(), files.end());
+
+  std::vector<CookedAsset> assets;
+  std::vector<fs::path> pngs;
+  std::vector<std::string> textureNames;
+  std::uint64_t rawBytes = 0;
+  std::uint64_t storedBytes = 0;
+
+  for (const auto &file : files) {
+    const std::string name = runtimeName(root, file);
+    if (name.size() >= packNameLength) {
+      std::cerr << "Skipping " << name << ": name too long\n";
+      continue;
+    }
+
+    CookedAsset asset{};
+    std::strncpy(asset.entry.name, name.c_str(), packNameLength - 1);
+
+    const bool ok =
+        isPng(file) ? cookTexture(file, asset, useLz4) : cookRaw(file, asset);
+    if (!ok) {
+      IMG_Quit();
+      return 1;
+    }
+
+    if (asset.entry.type == PackEntryType::Texture) {
+      pngs.push_back(file);
+      textureNames.push_back(name);
+    }
+    rawBytes += asset.entry.rawSize;
+    storedBytes += asset.blob.size();
+    assets.push_back(std::move(asset));
+  }
+
+  if (!writePack(output, assets)) {
+    IMG_Quit();
+    return 1;
+  }
+
+  std::cout << "Cooked " << assets.size() << " assets into " << output << " ("
+            << rawBytes << " bytes raw, " << storedBytes << " bytes stored)\n";
+
+  if (runBench) {
+    bench(pngs, textureNames, output);
+  }
+
+  IMG_Quit();
+  return 0;
+}